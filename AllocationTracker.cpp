@@ -0,0 +1,94 @@
+//
+//  AllocationTracker.cpp
+//  MinusMinusV3
+//
+
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include "RunStats.h"
+
+#ifdef MM_TRACK_ALLOCATIONS
+
+thread_local AllocationPhase allocationPhase = ALLOC_OTHER;
+
+// every thread adds to these, relaxed atomics since only the totals matter
+static atomic<long> phaseAllocations[ALLOC_PHASES];
+static atomic<long long> phaseBytes[ALLOC_PHASES];
+static atomic<long long> liveBytes;
+static atomic<long long> peakBytes;
+
+// in front of every block so operator delete knows its size, keeps the block aligned
+const size_t ALLOCATION_HEADER = alignof(max_align_t);
+
+#endif
+
+// every allocation of the program comes through here, counted for the run on this thread
+void *operator new(size_t size) {
+    RunStats *stats = currentStats;
+    if (stats != NULL) {
+        stats->allocations++;
+        stats->bytesAllocated += size;
+    }
+#ifdef MM_TRACK_ALLOCATIONS
+    AllocationPhase phase = allocationPhase;
+    phaseAllocations[phase].fetch_add(1, memory_order_relaxed);
+    phaseBytes[phase].fetch_add(size, memory_order_relaxed);
+    long long live = liveBytes.fetch_add(size, memory_order_relaxed) + size;
+    long long peak = peakBytes.load(memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed));
+    char *block = (char *) malloc(size + ALLOCATION_HEADER);
+    if (block == NULL)
+        throw bad_alloc();
+    *(size_t *) block = size;
+    return block + ALLOCATION_HEADER;
+#else
+    void *memory = malloc(size > 0 ? size : 1);
+    if (memory == NULL)
+        throw bad_alloc();
+    return memory;
+#endif
+}
+
+void operator delete(void *memory) noexcept {
+#ifdef MM_TRACK_ALLOCATIONS
+    if (memory == NULL)
+        return;
+    char *block = (char *) memory - ALLOCATION_HEADER;
+    liveBytes.fetch_sub(*(size_t *) block, memory_order_relaxed);
+    free(block);
+#else
+    free(memory);
+#endif
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+/** printAllocations
+ input: out
+ output: print allocations and bytes per phase, then the bytes live now and at the peak
+ */
+void printAllocations(ostream &out) {
+#ifdef MM_TRACK_ALLOCATIONS
+    const char *names[] = {"other", "load", "execute", "parse", "evaluate", "call", "print"};
+    long totalAllocations = 0;
+    long long totalBytes = 0;
+    out << "phase        allocations         bytes" << endl;
+    for (int i = 0; i < ALLOC_PHASES; i++) {
+        long allocations = phaseAllocations[i].load();
+        long long bytes = phaseBytes[i].load();
+        totalAllocations += allocations;
+        totalBytes += bytes;
+        out << left << setw(10) << names[i] << right << setw(14) << allocations << setw(14) << bytes << endl;
+    }
+    out << left << setw(10) << "total" << right << setw(14) << totalAllocations << setw(14) << totalBytes << endl;
+    out << "live bytes " << liveBytes.load() << ", peak live bytes " << peakBytes.load() << endl;
+#else
+    out << "Allocation tracking is off, build with -DMM_TRACK_ALLOCATIONS=ON" << endl;
+#endif
+} // end printAllocations
@@ -0,0 +1,60 @@
+//
+//  AllocationTracker.h
+//  MinusMinusV3
+//
+/*
+ Allocation tracking build mode (cmake -DMM_TRACK_ALLOCATIONS=ON). The
+ global operator new then also counts allocations and bytes per interpreter
+ phase, and the bytes live and their peak. The phase is whatever the
+ innermost AllocationScope on the thread says, so a parseEquation called by
+ PRINTLN counts as parse and a call made from the equation counts as call.
+
+ In a normal build AllocationScope is empty, costs nothing, and
+ printAllocations only says that tracking is off.
+ */
+#ifndef AllocationTracker_h
+#define AllocationTracker_h
+
+#include <iostream>
+
+using namespace std;
+
+enum AllocationPhase {
+    ALLOC_OTHER, ALLOC_LOAD, ALLOC_EXECUTE, ALLOC_PARSE, ALLOC_EVALUATE, ALLOC_CALL, ALLOC_PRINT, ALLOC_PHASES
+};
+
+#ifdef MM_TRACK_ALLOCATIONS
+
+extern thread_local AllocationPhase allocationPhase; // phase of the code running on this thread
+
+// sets the phase for its lifetime
+class AllocationScope {
+private:
+    AllocationPhase saved;
+
+public:
+    AllocationScope(AllocationPhase phase) : saved(allocationPhase) {
+        allocationPhase = phase;
+    }
+
+    ~AllocationScope() {
+        allocationPhase = saved;
+    }
+};
+
+#else
+
+class AllocationScope {
+public:
+    AllocationScope(AllocationPhase) {}
+};
+
+#endif
+
+/** printAllocations
+ input: out
+ output: print allocations and bytes per phase, then the bytes live now and at the peak
+ */
+void printAllocations(ostream &out);
+
+#endif /* AllocationTracker_h */
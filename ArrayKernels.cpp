@@ -0,0 +1,341 @@
+//
+//  ArrayKernels.cpp
+//  MinusMinusV3
+//
+
+#include "ArrayKernels.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ARRAY_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+// scalar kernels, also finish the tail of the vector ones
+
+static void fillScalar(int *values, int count, int value) {
+    for (int i = 0; i < count; i++)
+        values[i] = value;
+}
+
+static int sumScalar(const int *values, int count) {
+    unsigned int total = 0;
+    for (int i = 0; i < count; i++)
+        total += values[i];
+    return (int) total;
+}
+
+static int minScalar(const int *values, int count) {
+    int result = values[0];
+    for (int i = 1; i < count; i++)
+        if (values[i] < result)
+            result = values[i];
+    return result;
+}
+
+static int maxScalar(const int *values, int count) {
+    int result = values[0];
+    for (int i = 1; i < count; i++)
+        if (values[i] > result)
+            result = values[i];
+    return result;
+}
+
+static int countEqualScalar(const int *values, int count, int value) {
+    int found = 0;
+    for (int i = 0; i < count; i++)
+        found += values[i] == value;
+    return found;
+}
+
+static int dotScalar(const int *a, const int *b, int count) {
+    unsigned int total = 0;
+    for (int i = 0; i < count; i++)
+        total += (unsigned int) a[i] * (unsigned int) b[i];
+    return (int) total;
+}
+
+static int prefixSumScalar(int *values, int count) {
+    unsigned int total = 0;
+    for (int i = 0; i < count; i++)
+        values[i] = (int) (total += values[i]);
+    return (int) total;
+}
+
+static const ArrayKernels scalarKernels = {"scalar", fillScalar, sumScalar, minScalar, maxScalar, countEqualScalar,
+                                           dotScalar, prefixSumScalar};
+
+#ifdef ARRAY_KERNELS_X86
+
+// SSE2, 4 ints at a time. SSE2 has no 32 bit min, max or multiply, so they are built from compares and pmuludq
+
+__attribute__((target("sse2")))
+static int horizontalAdd128(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+__attribute__((target("sse2")))
+static void fillSse2(int *values, int count, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i *) (values + i), v);
+    fillScalar(values + i, count - i, value);
+}
+
+__attribute__((target("sse2")))
+static int sumSse2(const int *values, int count) {
+    __m128i total = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+        total = _mm_add_epi32(total, _mm_loadu_si128((const __m128i *) (values + i)));
+    return (int) ((unsigned int) horizontalAdd128(total) + (unsigned int) sumScalar(values + i, count - i));
+}
+
+__attribute__((target("sse2")))
+static __m128i min128(__m128i a, __m128i b) {
+    __m128i aBigger = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(aBigger, b), _mm_andnot_si128(aBigger, a));
+}
+
+__attribute__((target("sse2")))
+static __m128i max128(__m128i a, __m128i b) {
+    __m128i aBigger = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(aBigger, a), _mm_andnot_si128(aBigger, b));
+}
+
+__attribute__((target("sse2")))
+static int minSse2(const int *values, int count) {
+    if (count < 4)
+        return minScalar(values, count);
+    __m128i best = _mm_loadu_si128((const __m128i *) values);
+    __m128i other = best; // a second chain, the emulated min is three instructions deep
+    int i = 4;
+    for (; i + 8 <= count; i += 8) {
+        best = min128(best, _mm_loadu_si128((const __m128i *) (values + i)));
+        other = min128(other, _mm_loadu_si128((const __m128i *) (values + i + 4)));
+    }
+    for (; i + 4 <= count; i += 4)
+        best = min128(best, _mm_loadu_si128((const __m128i *) (values + i)));
+    best = min128(best, other);
+    best = min128(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = min128(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(best);
+    return i < count ? min(result, minScalar(values + i, count - i)) : result;
+}
+
+__attribute__((target("sse2")))
+static int maxSse2(const int *values, int count) {
+    if (count < 4)
+        return maxScalar(values, count);
+    __m128i best = _mm_loadu_si128((const __m128i *) values);
+    __m128i other = best; // a second chain, the emulated max is three instructions deep
+    int i = 4;
+    for (; i + 8 <= count; i += 8) {
+        best = max128(best, _mm_loadu_si128((const __m128i *) (values + i)));
+        other = max128(other, _mm_loadu_si128((const __m128i *) (values + i + 4)));
+    }
+    for (; i + 4 <= count; i += 4)
+        best = max128(best, _mm_loadu_si128((const __m128i *) (values + i)));
+    best = max128(best, other);
+    best = max128(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = max128(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(best);
+    return i < count ? max(result, maxScalar(values + i, count - i)) : result;
+}
+
+__attribute__((target("sse2")))
+static int countEqualSse2(const int *values, int count, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    __m128i found = _mm_setzero_si128(); // each equal lane adds -1
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+        found = _mm_add_epi32(found, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (values + i)), v));
+    return -horizontalAdd128(found) + countEqualScalar(values + i, count - i, value);
+}
+
+__attribute__((target("sse2")))
+static int dotSse2(const int *a, const int *b, int count) {
+    __m128i total = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *) (b + i));
+        __m128i even = _mm_mul_epu32(x, y); // lanes 0 and 2, low 32 bits are the wrapped product
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32)); // lanes 1 and 3
+        total = _mm_add_epi32(total, _mm_unpacklo_epi64(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                                        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))));
+    }
+    return (int) ((unsigned int) horizontalAdd128(total) + (unsigned int) dotScalar(a + i, b + i, count - i));
+}
+
+__attribute__((target("sse2")))
+static int prefixSumSse2(int *values, int count) {
+    __m128i carry = _mm_setzero_si128(); // running total in every lane
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (values + i));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128((__m128i *) (values + i), v);
+        carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    unsigned int total = (unsigned int) _mm_cvtsi128_si32(carry);
+    for (; i < count; i++)
+        values[i] = (int) (total += values[i]);
+    return (int) total;
+}
+
+static const ArrayKernels sse2Kernels = {"sse2", fillSse2, sumSse2, minSse2, maxSse2, countEqualSse2, dotSse2,
+                                         prefixSumSse2};
+
+// AVX2, 8 ints at a time
+
+__attribute__((target("avx2")))
+static int horizontalAdd256(__m256i v) {
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(half);
+}
+
+__attribute__((target("avx2")))
+static void fillAvx2(int *values, int count, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_si256((__m256i *) (values + i), v);
+    fillScalar(values + i, count - i, value);
+}
+
+__attribute__((target("avx2")))
+static int sumAvx2(const int *values, int count) {
+    __m256i total = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        total = _mm256_add_epi32(total, _mm256_loadu_si256((const __m256i *) (values + i)));
+    return (int) ((unsigned int) horizontalAdd256(total) + (unsigned int) sumScalar(values + i, count - i));
+}
+
+__attribute__((target("avx2")))
+static int minAvx2(const int *values, int count) {
+    if (count < 8)
+        return minScalar(values, count);
+    __m256i best = _mm256_loadu_si256((const __m256i *) values);
+    int i = 8;
+    for (; i + 8 <= count; i += 8)
+        best = _mm256_min_epi32(best, _mm256_loadu_si256((const __m256i *) (values + i)));
+    __m128i half = _mm_min_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(half);
+    return i < count ? min(result, minScalar(values + i, count - i)) : result;
+}
+
+__attribute__((target("avx2")))
+static int maxAvx2(const int *values, int count) {
+    if (count < 8)
+        return maxScalar(values, count);
+    __m256i best = _mm256_loadu_si256((const __m256i *) values);
+    int i = 8;
+    for (; i + 8 <= count; i += 8)
+        best = _mm256_max_epi32(best, _mm256_loadu_si256((const __m256i *) (values + i)));
+    __m128i half = _mm_max_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    half = _mm_max_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_max_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(half);
+    return i < count ? max(result, maxScalar(values + i, count - i)) : result;
+}
+
+__attribute__((target("avx2")))
+static int countEqualAvx2(const int *values, int count, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    __m256i found = _mm256_setzero_si256(); // each equal lane adds -1
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        found = _mm256_add_epi32(found, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *) (values + i)), v));
+    return -horizontalAdd256(found) + countEqualScalar(values + i, count - i, value);
+}
+
+__attribute__((target("avx2")))
+static int dotAvx2(const int *a, const int *b, int count) {
+    __m256i total = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        total = _mm256_add_epi32(total, _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *) (a + i)),
+                                                           _mm256_loadu_si256((const __m256i *) (b + i))));
+    return (int) ((unsigned int) horizontalAdd256(total) + (unsigned int) dotScalar(a + i, b + i, count - i));
+}
+
+__attribute__((target("avx2")))
+static int prefixSumAvx2(int *values, int count) {
+    __m256i carry = _mm256_setzero_si256(); // running total in every lane
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (values + i));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4)); // scan within each 128 bit half
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        __m256i lowTotal = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(3)); // last of the low half everywhere
+        v = _mm256_add_epi32(v, _mm256_blend_epi32(_mm256_setzero_si256(), lowTotal, 0xF0)); // into the high half
+        v = _mm256_add_epi32(v, carry);
+        _mm256_storeu_si256((__m256i *) (values + i), v);
+        carry = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(7));
+    }
+    unsigned int total = (unsigned int) _mm256_cvtsi256_si32(carry);
+    for (; i < count; i++)
+        values[i] = (int) (total += values[i]);
+    return (int) total;
+}
+
+static const ArrayKernels avx2Kernels = {"avx2", fillAvx2, sumAvx2, minAvx2, maxAvx2, countEqualAvx2, dotAvx2,
+                                         prefixSumAvx2};
+
+#endif
+
+static const ArrayKernels *chosen = NULL; // set once, every thread then reads it
+
+/** bestKernels
+ output: return the kernels for the widest vectors this CPU supports
+ */
+static const ArrayKernels *bestKernels() {
+#ifdef ARRAY_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return &avx2Kernels;
+    if (__builtin_cpu_supports("sse2"))
+        return &sse2Kernels;
+#endif
+    return &scalarKernels;
+} // end bestKernels
+
+const ArrayKernels &arrayKernels() {
+    static const ArrayKernels *best = bestKernels(); // thread safe static initialization
+    return chosen != NULL ? *chosen : *best;
+}
+
+/** selectArrayKernels
+ input: name of a kernel set
+ output: use that set from now on and return true, or return false if this CPU cannot run it.
+ Call before any run starts, the choice is not synchronized
+ changed: chosen
+ */
+bool selectArrayKernels(const char *name) {
+    const ArrayKernels *kernels = NULL;
+    if (strcmp(name, "scalar") == 0)
+        kernels = &scalarKernels;
+#ifdef ARRAY_KERNELS_X86
+    __builtin_cpu_init();
+    if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2"))
+        kernels = &sse2Kernels;
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2"))
+        kernels = &avx2Kernels;
+#endif
+    if (kernels == NULL)
+        return false;
+    chosen = kernels;
+    return true;
+} // end selectArrayKernels
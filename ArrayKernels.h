@@ -0,0 +1,37 @@
+//
+//  ArrayKernels.h
+//  MinusMinusV3
+//
+/*
+ Whole array loops behind the array builtins (fill, copy, sum, minof, maxof,
+ counteq, dot and prefixsum). Each kernel has a scalar version and, on x86,
+ SSE2 and AVX2 versions compiled with target attributes, so the rest of the
+ program needs no special flags. arrayKernels picks the best set this CPU
+ supports the first time it is called.
+
+ Sums, dot products and prefix sums wrap around on overflow, like the
+ interpreter's own int arithmetic does on every machine it runs on.
+ */
+#ifndef ArrayKernels_h
+#define ArrayKernels_h
+
+using namespace std;
+
+struct ArrayKernels {
+    const char *name; // "scalar", "sse2" or "avx2"
+    void (*fill)(int *values, int count, int value);
+    int (*sum)(const int *values, int count);
+    int (*minOf)(const int *values, int count); // count > 0
+    int (*maxOf)(const int *values, int count); // count > 0
+    int (*countEqual)(const int *values, int count, int value);
+    int (*dot)(const int *a, const int *b, int count);
+    int (*prefixSum)(int *values, int count); // in place, returns the last sum
+};
+
+// the fastest kernels this CPU supports
+const ArrayKernels &arrayKernels();
+
+// use the kernels called name instead ("scalar", "sse2" or "avx2"), false if this CPU cannot run them
+bool selectArrayKernels(const char *name);
+
+#endif /* ArrayKernels_h */
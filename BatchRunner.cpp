@@ -0,0 +1,287 @@
+//
+//  BatchRunner.cpp
+//  MinusMinusV3
+//
+
+#include "BatchRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include "CompiledProgram.h"
+#include "ExecutionContext.h"
+#include "Scheduler.h"
+#include "ThreadPool.h"
+#include "support.hpp"
+
+// a script loaded once and shared by every job that runs it
+struct LoadedScript {
+    once_flag once;
+    unique_ptr<CompiledProgram> prog;
+    bool read;
+    string messages; // load errors, copied into the output of every job
+};
+
+/** baseName
+ input: path
+ output: return the file name of path without directory and extension
+ */
+static string baseName(string path) {
+    size_t slash = path.find_last_of('/');
+    if (slash != string::npos)
+        path = path.substr(slash + 1);
+    size_t dot = path.find_last_of('.');
+    if (dot != string::npos && dot > 0)
+        path = path.substr(0, dot);
+    return path;
+} // end baseName
+
+/** addJob
+ input: jobs, script and input
+ output: add a job named by its position and script so output files never collide
+ changed: jobs
+ */
+static void addJob(vector<BatchJob> &jobs, string script, string input) {
+    ostringstream name;
+    name << setw(4) << setfill('0') << jobs.size() + 1 << "_" << baseName(script);
+    BatchJob job;
+    job.script = script;
+    job.input = input;
+    job.name = name.str();
+    jobs.push_back(job);
+} // end addJob
+
+/** readJobs
+ input: path of a manifest file or a directory of scripts, and jobs
+ output: add a BatchJob to jobs for every script found. Return false if path could not be read
+ changed: jobs
+ */
+bool readJobs(string path, vector<BatchJob> &jobs) {
+    DIR *dir = opendir(path.c_str());
+    if (dir != NULL) { // every .mm in the directory
+        vector<string> scripts;
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            string file = entry->d_name;
+            if (file.length() > 3 && file.substr(file.length() - 3) == ".mm")
+                scripts.push_back(file);
+        }
+        closedir(dir);
+        sort(scripts.begin(), scripts.end());
+        for (int i = 0; i < scripts.size(); i++) {
+            string script = path + "/" + scripts[i];
+            string input = path + "/" + baseName(scripts[i]) + ".in";
+            ifstream test(input.c_str());
+            addJob(jobs, script, test.good() ? input : "");
+        }
+        return true;
+    }
+    ifstream manifest(path.c_str());
+    if (manifest.fail())
+        return false;
+    string folder = "";
+    size_t slash = path.find_last_of('/');
+    if (slash != string::npos)
+        folder = path.substr(0, slash + 1);
+    string line;
+    while (getline(manifest, line)) {
+        istringstream words(line);
+        string script, input;
+        words >> script >> input;
+        if (script == "" || script[0] == ';' || script[0] == '#')
+            continue;
+        if (script[0] != '/')
+            script = folder + script;
+        if (input != "" && input[0] != '/')
+            input = folder + input;
+        addJob(jobs, script, input);
+    }
+    return true;
+} // end readJobs
+
+/** loadScript
+ input: job and loaded
+ output: load the script of job into loaded unless that already happened (safe from any thread)
+ changed: loaded
+ */
+static void loadScript(BatchJob &job, LoadedScript &loaded) {
+    call_once(loaded.once, [&job, &loaded] {
+        ostringstream messages;
+        ifstream inFile(job.script.c_str());
+        loaded.prog.reset(new CompiledProgram);
+        loaded.read = loaded.prog->loadProg(inFile, false, messages);
+        loaded.messages = messages.str();
+    });
+} // end loadScript
+
+/** readInput
+ input: job and in
+ output: fill in with the contents of the job's INPUT file (nothing if it has none)
+ changed: in
+ */
+static void readInput(BatchJob &job, istringstream &in) {
+    if (job.input != "") {
+        ifstream inFile(job.input.c_str());
+        ostringstream contents;
+        contents << inFile.rdbuf();
+        in.str(contents.str());
+    }
+} // end readInput
+
+/** statusOf
+ input: context after its run and the errors run() returned
+ output: the BatchStatus of the run
+ */
+static BatchStatus statusOf(ExecutionContext &context, int errors) {
+    if (context.isLimitExceeded())
+        return BATCH_LIMIT;
+    return errors > 0 ? BATCH_ERROR : BATCH_OK;
+} // end statusOf
+
+/** runJob
+ input: job, the script it runs, options and the seed for its rand()
+ output: run job in its own ExecutionContext and return what happened
+ */
+static BatchResult runJob(BatchJob &job, LoadedScript &loaded, BatchOptions &options, unsigned int seed) {
+    BatchResult result;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    loadScript(job, loaded);
+    ostringstream out;
+    out << loaded.messages;
+    result.errors = loaded.prog->getLoadErrors();
+    result.statements = 0;
+    if (!loaded.read || result.errors > 0)
+        result.status = BATCH_LOAD_FAILED;
+    else {
+        istringstream in;
+        readInput(job, in);
+        ExecutionContext context(*loaded.prog, seed);
+        context.setIO(in, out);
+        context.setErrorStream(out);
+        context.setLimits(options.maxStatements, options.deadlineMs);
+        result.errors = run(context);
+        result.statements = context.getStatementCount();
+        result.status = statusOf(context, result.errors);
+    }
+    result.output = out.str();
+    result.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return result;
+} // end runJob
+
+/** writeOutput
+ input: outDir, job and result
+ output: write the output of job to outDir/name.out (nothing when outDir is ""). If the file
+ could not be written the status of result becomes BATCH_WRITE_FAILED
+ changed: result
+ */
+static void writeOutput(string outDir, BatchJob &job, BatchResult &result) {
+    if (outDir != "") {
+        ofstream outFile((outDir + "/" + job.name + ".out").c_str());
+        outFile << result.output << flush;
+        if (outFile.fail())
+            result.status = BATCH_WRITE_FAILED;
+    }
+} // end writeOutput
+
+/** runScheduled
+ input: jobs, scripts and options
+ output: run every job as a green thread on a Scheduler and fill in results
+ changed: scripts and results
+ */
+static void runScheduled(vector<BatchJob> &jobs, map<string, LoadedScript> &scripts, BatchOptions &options,
+                         vector<BatchResult> &results) {
+    struct Run {
+        istringstream in;
+        ostringstream out;
+        unique_ptr<ExecutionContext> context;
+        int task;
+    };
+    vector<unique_ptr<Run>> runs;
+    Scheduler scheduler(options.threads, options.quantum);
+    for (int i = 0; i < jobs.size(); i++) {
+        LoadedScript &loaded = scripts.find(jobs[i].script)->second;
+        loadScript(jobs[i], loaded);
+        Run *r = new Run;
+        runs.push_back(unique_ptr<Run>(r));
+        r->out << loaded.messages;
+        r->task = -1;
+        results[i].errors = loaded.prog->getLoadErrors();
+        results[i].statements = 0;
+        results[i].wallMs = 0;
+        if (!loaded.read || results[i].errors > 0) {
+            results[i].status = BATCH_LOAD_FAILED;
+            continue;
+        }
+        readInput(jobs[i], r->in);
+        r->context.reset(new ExecutionContext(*loaded.prog, i + 1)); // same seed every batch
+        r->context->setIO(r->in, r->out);
+        r->context->setErrorStream(r->out);
+        r->context->setLimits(options.maxStatements, options.deadlineMs); // deadline counts time waiting for a turn
+        r->task = scheduler.add(*r->context);
+    }
+    scheduler.runAll();
+    for (int i = 0; i < jobs.size(); i++) {
+        Run &r = *runs[i];
+        if (r.task >= 0) {
+            results[i].errors = scheduler.getErrors(r.task);
+            results[i].statements = r.context->getStatementCount();
+            results[i].wallMs = scheduler.getWallMs(r.task);
+            results[i].status = statusOf(*r.context, results[i].errors);
+        }
+        results[i].output = r.out.str();
+        writeOutput(options.outDir, jobs[i], results[i]);
+    }
+} // end runScheduled
+
+/** runBatch
+ input: jobs and options
+ output: run every job and return the results in the order of jobs. When options.outDir
+ is not "" each job's output is written to outDir/name.out, and a job whose file could not
+ be written has the status BATCH_WRITE_FAILED
+ */
+vector<BatchResult> runBatch(vector<BatchJob> &jobs, BatchOptions &options) {
+    vector<BatchResult> results(jobs.size());
+    map<string, LoadedScript> scripts; // filled before any task starts, read only after
+    for (int i = 0; i < jobs.size(); i++)
+        scripts[jobs[i].script];
+    if (options.quantum > 0) {
+        runScheduled(jobs, scripts, options, results);
+        return results;
+    }
+    {
+        ThreadPool pool(options.threads);
+        for (int i = 0; i < jobs.size(); i++) {
+            pool.submit([i, &jobs, &results, &scripts, &options] {
+                LoadedScript &loaded = scripts.find(jobs[i].script)->second;
+                results[i] = runJob(jobs[i], loaded, options, i + 1); // same seed every batch
+                writeOutput(options.outDir, jobs[i], results[i]);
+            });
+        }
+        pool.wait();
+    }
+    return results;
+} // end runBatch
+
+/** writeSummary
+ input: filename, jobs and their results
+ output: write one CSV line per job with its status, errors, statements and wall time.
+ Return false if the file could not be written
+ */
+bool writeSummary(string filename, vector<BatchJob> &jobs, vector<BatchResult> &results) {
+    const char *statusNames[] = {"ok", "error", "load_failed", "limit", "write_failed"};
+    ofstream summary(filename.c_str());
+    if (summary.fail())
+        return false;
+    summary << "name,script,status,errors,statements,wall_ms" << endl;
+    for (int i = 0; i < jobs.size(); i++) {
+        summary << jobs[i].name << "," << jobs[i].script << "," << statusNames[results[i].status] << ","
+                << results[i].errors << "," << results[i].statements << ","
+                << fixed << setprecision(3) << results[i].wallMs << endl;
+    }
+    return !summary.fail();
+} // end writeSummary
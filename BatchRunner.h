@@ -0,0 +1,76 @@
+//
+//  BatchRunner.h
+//  MinusMinusV3
+//
+/*
+ Batch mode: run many MinusMinus scripts on a ThreadPool. Every script gets
+ its own ExecutionContext with its output captured, so scripts never share
+ anything but the read only CompiledProgram of a script listed more than once.
+
+ A manifest has one job per line: the script and, optionally, a file to use
+ as its INPUT. Relative paths are relative to the manifest. Blank lines and
+ lines starting with ; or # are skipped. A directory runs every .mm file in
+ it (sorted by name), with name.in as the INPUT of name.mm when it exists.
+ */
+#ifndef BatchRunner_h
+#define BatchRunner_h
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum BatchStatus {
+    BATCH_OK, BATCH_ERROR, BATCH_LOAD_FAILED, BATCH_LIMIT, BATCH_WRITE_FAILED // name.out could not be written
+};
+
+// how runBatch runs the jobs
+struct BatchOptions {
+    int threads; // 0 for one per hardware thread
+    string outDir; // write name.out files here, "" to keep output in BatchResult only
+    int quantum; // 0 runs each job to the end on a ThreadPool, else green threads switching every quantum lines
+    long maxStatements; // stop a job after this many lines, 0 for no limit
+    long deadlineMs; // stop a job after this many milliseconds, 0 for no limit
+
+    BatchOptions() : threads(0), quantum(0), maxStatements(0), deadlineMs(0) {}
+};
+
+// one script to run
+struct BatchJob {
+    string script; // path of the .mm file
+    string input; // path of the INPUT file, "" for none
+    string name; // unique name used for the output file
+};
+
+// what happened when a BatchJob ran
+struct BatchResult {
+    BatchStatus status;
+    int errors;
+    long statements; // lines dispatched
+    double wallMs; // load and run time
+    string output; // everything the script printed, errors included
+};
+
+/** readJobs
+ input: path of a manifest file or a directory of scripts, and jobs
+ output: add a BatchJob to jobs for every script found. Return false if path could not be read
+ changed: jobs
+ */
+bool readJobs(string path, vector<BatchJob> &jobs);
+
+/** runBatch
+ input: jobs and options
+ output: run every job and return the results in the order of jobs. When options.outDir
+ is not "" each job's output is written to outDir/name.out, and a job whose file could not
+ be written has the status BATCH_WRITE_FAILED
+ */
+vector<BatchResult> runBatch(vector<BatchJob> &jobs, BatchOptions &options);
+
+/** writeSummary
+ input: filename, jobs and their results
+ output: write one CSV line per job with its status, errors, statements and wall time.
+ Return false if the file could not be written
+ */
+bool writeSummary(string filename, vector<BatchJob> &jobs, vector<BatchResult> &results);
+
+#endif /* BatchRunner_h */
@@ -0,0 +1,301 @@
+//
+//  Builtins.cpp
+//  MinusMinusV3
+//
+
+#include "Builtins.h"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include "ArrayKernels.h"
+#include "support.hpp"
+
+typedef int (*BuiltinCall)(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local);
+
+static int callNumber(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local);
+static int callArray(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local);
+static int callMap(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local);
+
+// a builtin: its name, the arrays or maps named first, the values after them and what runs it
+struct Builtin {
+    const char *name;
+    int names;
+    int values;
+    BuiltinCall call;
+};
+static const Builtin builtins[] = { // in BuiltinId order
+        {"rand", 0, 0, callNumber}, {"abs", 0, 1, callNumber}, {"min", 0, 2, callNumber},
+        {"max", 0, 2, callNumber}, {"pow", 0, 2, callNumber}, {"sqrt", 0, 1, callNumber},
+        {"gcd", 0, 2, callNumber},
+        {"fill", 1, 1, callArray}, {"copy", 2, 0, callArray}, {"sum", 1, 0, callArray},
+        {"minof", 1, 0, callArray}, {"maxof", 1, 0, callArray}, {"counteq", 1, 1, callArray},
+        {"dot", 2, 0, callArray}, {"prefixsum", 1, 0, callArray},
+        {"has", 1, 1, callMap}, {"size", 1, 0, callMap}, {"key", 1, 1, callMap},
+        {"remove", 1, 1, callMap}};
+
+/** builtinNames
+ output: return a map from each builtin's name to its id
+ */
+static map<string, BuiltinId> builtinNames() {
+    map<string, BuiltinId> names;
+    for (int id = 0; id < NO_BUILTIN; id++)
+        names[builtins[id].name] = (BuiltinId) id;
+    return names;
+} // end builtinNames
+
+// made before main runs, so no run pays for it and threads only ever read it
+static const map<string, BuiltinId> byName = builtinNames();
+
+/** findBuiltin
+ input: name of a function
+ output: return the id of the builtin called name, NO_BUILTIN if there is none
+ */
+BuiltinId findBuiltin(string name) {
+    map<string, BuiltinId>::const_iterator found = byName.find(name);
+    return found == byName.end() ? NO_BUILTIN : found->second;
+} // end findBuiltin
+
+/** callBuiltin
+ input: id of a builtin, args (in parenthesis) and the caller's local SymbolTable
+ output: run the builtin on args and return its value, an error for an id out of range
+ changed: p, args and any array or map the builtin writes
+ */
+int callBuiltin(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local) {
+    if (id < 0 || id >= NO_BUILTIN) {
+        p.errorMsg("Unknown builtin " + to_string((int) id));
+        return 0;
+    }
+    return builtins[id].call(p, id, args, local);
+} // end callBuiltin
+
+/** numberArgs
+ input: id of a number builtin, args (in parenthesis), local SymbolTable and numbers (room for 2)
+ output: work out the values in args into numbers and return true if there are as many as id takes
+ changed: p, args and numbers
+ */
+static bool numberArgs(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local, int numbers[]) {
+    const Builtin &builtin = builtins[id];
+    int given = 0;
+    bool success;
+    p.trim(PARENTHESIS, args);
+    p.trimIt(args);
+    while (args != "") {
+        string token = p.nextToken(args, END_COMMA);
+        if (given < builtin.values)
+            numbers[given] = parseEquation(p, token, local, success);
+        given++;
+        if (args != "" && p.nextToken(args, END_COMMA) != ",")
+            p.errorMsg("Missing comma");
+    }
+    if (given == builtin.values)
+        return true;
+    if (builtin.values == 0)
+        p.errorMsg(string("built-in function ") + builtin.name + " has no parameters");
+    else
+        p.errorMsg(string("built-in function ") + builtin.name + " needs " + to_string(builtin.values)
+                   + (builtin.values == 1 ? " value" : " values"));
+    return false;
+} // end numberArgs
+
+/** power
+ input: base and exponent
+ output: base to the exponent, wrapping around on overflow. A negative exponent truncates
+ like / does (0 unless base is 1 or -1) and is an error for a base of 0
+ */
+static int power(ExecutionContext &p, int base, int exponent) {
+    if (exponent < 0) {
+        if (base == 0)
+            p.errorMsg("Division by zero");
+        else if (base == 1 || base == -1)
+            return exponent % 2 == 0 ? 1 : base;
+        return 0;
+    }
+    unsigned int result = 1, factor = base; // unsigned so overflow wraps
+    while (exponent > 0) {
+        if (exponent & 1)
+            result *= factor;
+        factor *= factor;
+        exponent >>= 1;
+    }
+    return (int) result;
+} // end power
+
+/** squareRoot
+ input: x (not negative)
+ output: the largest int whose square is at most x
+ */
+static int squareRoot(int x) {
+    int root = (int) sqrt((double) x);
+    while ((long long) root * root > x) // fix any rounding of the double
+        root--;
+    while ((long long) (root + 1) * (root + 1) <= x)
+        root++;
+    return root;
+} // end squareRoot
+
+/** callNumber
+ input: id of a number builtin, args (in parenthesis) and the caller's local SymbolTable
+ output: return the builtin of the values in args
+ changed: p and args
+ */
+static int callNumber(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local) {
+    int numbers[2];
+    if (!numberArgs(p, id, args, local, numbers))
+        return 0;
+    int a = numbers[0], b = numbers[1];
+    switch (id) {
+        case BUILTIN_RAND:
+            return p.nextRandom();
+        case BUILTIN_ABS:
+            return a < 0 ? (int) (0u - (unsigned int) a) : a;
+        case BUILTIN_MIN:
+            return a < b ? a : b;
+        case BUILTIN_MAX:
+            return a > b ? a : b;
+        case BUILTIN_POW:
+            return power(p, a, b);
+        case BUILTIN_SQRT:
+            if (a < 0) {
+                p.errorMsg("sqrt of negative number " + to_string(a));
+                return 0;
+            }
+            return squareRoot(a);
+        case BUILTIN_GCD: {
+            unsigned int x = a < 0 ? 0u - (unsigned int) a : a;
+            unsigned int y = b < 0 ? 0u - (unsigned int) b : b;
+            while (y != 0) { // Euclid
+                unsigned int rest = x % y;
+                x = y;
+                y = rest;
+            }
+            return (int) x;
+        }
+        default:
+            return 0;
+    }
+} // end callNumber
+
+/** callArray
+ input: id of an array builtin, args (in parenthesis) and the caller's local SymbolTable
+ output: run the builtin on the arrays and range named in args and return its value. The
+ arguments are the array(s), then the value (fill and counteq), then optionally the first
+ element and the number of elements (default: from there to the end of the shortest array).
+ fill and copy return the elements written, prefixsum the last sum
+ changed: p, args and the arrays written (fill, copy and prefixsum)
+ */
+static int callArray(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local) {
+    const Builtin &builtin = builtins[id];
+    vector<int> *arrays[2] = {NULL, NULL};
+    int numbers[3]; // value, start and count
+    int given = 0; // arguments after the arrays
+    int argument = 0;
+    bool success;
+    p.trim(PARENTHESIS, args);
+    while (args != "") {
+        string token = p.nextToken(args, END_COMMA);
+        if (argument < builtin.names) {
+            p.trimIt(token);
+            arrays[argument] = p.array(token, local);
+            if (arrays[argument] == NULL)
+                return 0;
+        } else if (given < 3)
+            numbers[given++] = parseEquation(p, token, local, success);
+        else
+            given++;
+        argument++;
+        if (args != "" && p.nextToken(args, END_COMMA) != ",")
+            p.errorMsg("Missing comma");
+    }
+    string name = builtin.name;
+    int extra = given - builtin.values; // 0 for the whole array, 2 for a range
+    if (argument < builtin.names || (extra != 0 && extra != 2)) {
+        p.errorMsg(name + " needs " + to_string(builtin.names) + " array(s)"
+                   + (builtin.values > 0 ? ", a value" : "") + " and optionally a start and count");
+        return 0;
+    }
+    int size = arrays[0]->size();
+    if (arrays[1] != NULL && arrays[1]->size() < size)
+        size = arrays[1]->size();
+    int value = builtin.values > 0 ? numbers[0] : 0;
+    int start = extra == 2 ? numbers[builtin.values] : 0;
+    int count = extra == 2 ? numbers[builtin.values + 1] : size;
+    if (start < 0 || count < 0 || start > size || count > size - start) {
+        p.errorMsg(name + " range of " + to_string(count) + " from " + to_string(start) + " is out of bounds");
+        return 0;
+    }
+    int *a = arrays[0]->data() + start;
+    const ArrayKernels &kernels = arrayKernels();
+    switch (id) {
+        case BUILTIN_FILL:
+            kernels.fill(a, count, value);
+            return count;
+        case BUILTIN_COPY:
+            memmove(a, arrays[1]->data() + start, count * sizeof(int));
+            return count;
+        case BUILTIN_SUM:
+            return kernels.sum(a, count);
+        case BUILTIN_COUNTEQ:
+            return kernels.countEqual(a, count, value);
+        case BUILTIN_DOT:
+            return kernels.dot(a, arrays[1]->data() + start, count);
+        case BUILTIN_PREFIXSUM:
+            return kernels.prefixSum(a, count);
+        default:
+            break;
+    }
+    if (count == 0) {
+        p.errorMsg(name + " of no elements");
+        return 0;
+    }
+    return id == BUILTIN_MINOF ? kernels.minOf(a, count) : kernels.maxOf(a, count);
+} // end callArray
+
+/** callMap
+ input: id of a map builtin, args (in parenthesis) and the caller's local SymbolTable
+ output: has(m, k) 1 if key k is in map m, size(m) its number of keys (or the length of an
+ array), key(m, i) key number i (0 to size(m) - 1, for walking a map) and remove(m, k)
+ 1 if k was taken out of m
+ changed: p, args and the map for remove
+ */
+static int callMap(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local) {
+    string name = builtins[id].name;
+    bool success, given = false;
+    int value = 0;
+    p.trim(PARENTHESIS, args);
+    string target = p.nextToken(args, END_COMMA);
+    p.trimIt(target);
+    if (args != "") {
+        if (p.nextToken(args, END_COMMA) != ",")
+            p.errorMsg("Missing comma");
+        value = parseEquation(p, p.nextToken(args, END_COMMA), local, success);
+        given = true;
+        if (args != "")
+            p.errorMsg(name + " has too many arguments");
+    }
+    if (target == "" || given != (builtins[id].values > 0)) {
+        p.errorMsg(id == BUILTIN_SIZE ? "size needs a map or an array" : name + " needs a map and a value");
+        return 0;
+    }
+    Symbol sym = Symbol(target, 0, NONE);
+    if (id == BUILTIN_SIZE && local.get(sym) && sym.getType() == ARRAY)
+        return p.array(target, local)->size();
+    IntMap *values = p.map(target, local);
+    if (values == NULL)
+        return 0;
+    switch (id) {
+        case BUILTIN_SIZE:
+            return values->size();
+        case BUILTIN_HAS:
+            return values->has(value);
+        case BUILTIN_REMOVE:
+            return values->remove(value);
+        default:
+            break;
+    }
+    if (value < 0 || value >= values->size()) {
+        p.errorMsg("Key number " + to_string(value) + " out of range for " + target + " of "
+                   + to_string(values->size()) + " keys");
+        return 0;
+    }
+    return values->keyAt(value);
+} // end callMap
@@ -0,0 +1,62 @@
+//
+//  Builtins.h
+//  MinusMinusV3
+//
+/*
+ The functions MinusMinus provides itself, written in C++ instead of as
+ FUNCTIONs of the script. loadProg looks up each call's name once: a CALL
+ line keeps the BuiltinId, and in expressions the name is swapped for
+ BUILTIN_CALL and the id, so a run goes straight to the id's entry in the
+ table without comparing names. A script's own FUNCTION or PROCEDURE with the
+ same name always wins over a builtin, and its calls are left alone.
+
+   numbers: rand(), abs(x), min(a, b), max(a, b), pow(b, e), sqrt(x), gcd(a, b)
+   arrays:  fill, copy, sum, minof, maxof, counteq, dot, prefixsum
+   maps:    has, size, key, remove
+
+ The number builtins use int arithmetic and wrap around on overflow, like the
+ interpreter's + and *. sqrt rounds down, pow with a negative exponent
+ truncates like / does, and gcd is never negative.
+
+ To add a builtin, give it an id below (in the same order as the table in
+ Builtins.cpp), a table entry with its name and number of values, and a
+ case in the call that handles its group.
+ */
+#ifndef Builtins_h
+#define Builtins_h
+
+#include <string>
+
+using namespace std;
+
+class ExecutionContext;
+class SymbolTable;
+
+enum BuiltinId {
+    BUILTIN_RAND, BUILTIN_ABS, BUILTIN_MIN, BUILTIN_MAX, BUILTIN_POW, BUILTIN_SQRT, BUILTIN_GCD,
+    BUILTIN_FILL, BUILTIN_COPY, BUILTIN_SUM, BUILTIN_MINOF, BUILTIN_MAXOF, BUILTIN_COUNTEQ,
+    BUILTIN_DOT, BUILTIN_PREFIXSUM,
+    BUILTIN_HAS, BUILTIN_SIZE, BUILTIN_KEY, BUILTIN_REMOVE,
+    NO_BUILTIN
+};
+
+// where loadProg took a builtin's name out of an expression: BUILTIN_CALL, then BUILTIN_ID_BASE + id.
+// The id is a letter so no tokenizer turns it into something else (nextToken makes a tab a space)
+const char BUILTIN_CALL = '\x01';
+const char BUILTIN_ID_BASE = 'A';
+
+/** findBuiltin
+ input: name of a function
+ output: return the id of the builtin called name, NO_BUILTIN if there is none (for loadProg,
+ a run only sees ids)
+ */
+BuiltinId findBuiltin(string name);
+
+/** callBuiltin
+ input: id of a builtin, args (in parenthesis) and the caller's local SymbolTable
+ output: run the builtin on args and return its value (an error for an id out of range)
+ changed: p, args and any array or map the builtin writes
+ */
+int callBuiltin(ExecutionContext &p, BuiltinId id, string &args, SymbolTable &local);
+
+#endif /* Builtins_h */
@@ -0,0 +1,100 @@
+//
+//  CallProfiler.cpp
+//  MinusMinusV3
+//
+
+#include "CallProfiler.h"
+#include <algorithm>
+#include <iomanip>
+
+CallProfiler::CallProfiler() {
+}
+
+/** enter
+ input: line (heading of the method, -1 for the main program) and name
+ output: open a frame for the call
+ changed: methods, frames and path
+ */
+void CallProfiler::enter(int line, string name) {
+    map<int, int>::iterator found = methodOfLine.find(line);
+    int method;
+    if (found != methodOfLine.end())
+        method = found->second;
+    else { // first call of this method
+        MethodStats stats;
+        stats.name = line < 0 ? "main" : name;
+        stats.calls = stats.inclusiveNs = stats.exclusiveNs = 0;
+        stats.depth = stats.maxDepth = 0;
+        method = methods.size();
+        methods.push_back(stats);
+        methodOfLine[line] = method;
+    }
+    MethodStats &stats = methods[method];
+    stats.calls++;
+    stats.depth++;
+    if (stats.depth > stats.maxDepth)
+        stats.maxDepth = stats.depth;
+    Frame frame;
+    frame.method = method;
+    frame.childNs = 0;
+    frames.push_back(frame);
+    path.push_back(method);
+    frames.back().start = chrono::steady_clock::now(); // last, so the bookkeeping is not timed
+} // end enter
+
+/** leave
+ output: close the innermost frame and add its time to its method, its caller and its call stack
+ changed: methods, frames, path and folded
+ */
+void CallProfiler::leave() {
+    if (frames.empty())
+        return;
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    Frame frame = frames.back();
+    long long ns = chrono::duration_cast<chrono::nanoseconds>(end - frame.start).count();
+    MethodStats &stats = methods[frame.method];
+    stats.depth--;
+    if (stats.depth == 0) // outermost activation, nested ones are inside this time
+        stats.inclusiveNs += ns;
+    stats.exclusiveNs += ns - frame.childNs;
+    folded[path] += ns - frame.childNs;
+    frames.pop_back();
+    path.pop_back();
+    if (!frames.empty())
+        frames.back().childNs += ns;
+} // end leave
+
+/** report
+ input: out
+ output: print one row per method that was called, most exclusive time first
+ */
+void CallProfiler::report(ostream &out) {
+    vector<int> order;
+    for (int i = 0; i < methods.size(); i++)
+        order.push_back(i);
+    sort(order.begin(), order.end(), [this](int a, int b) {
+        return methods[a].exclusiveNs > methods[b].exclusiveNs;
+    });
+    out << "method                calls  inclusive ms  exclusive ms  max depth" << endl;
+    for (int i = 0; i < order.size(); i++) {
+        MethodStats &m = methods[order[i]];
+        out << left << setw(16) << m.name << right << setw(11) << m.calls
+            << fixed << setprecision(3) << setw(14) << m.inclusiveNs / 1e6 << setw(14) << m.exclusiveNs / 1e6
+            << setw(11) << m.maxDepth << endl;
+    }
+} // end report
+
+/** writeFolded
+ input: out
+ output: print "main;caller;callee microseconds" for every call stack seen. Times are
+ rounded up and every stack seen gets at least 1, so short calls still show in a flame graph
+ */
+void CallProfiler::writeFolded(ostream &out) {
+    for (map<vector<int>, long long>::iterator it = folded.begin(); it != folded.end(); it++) {
+        const vector<int> &stack = it->first;
+        for (int i = 0; i < stack.size(); i++)
+            out << (i > 0 ? ";" : "") << methods[stack[i]].name;
+        long long us = (it->second + 999) / 1000;
+        out << " " << (us > 0 ? us : 1) << endl;
+    }
+} // end writeFolded
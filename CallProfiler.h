@@ -0,0 +1,63 @@
+//
+//  CallProfiler.h
+//  MinusMinusV3
+//
+/*
+ Profiles user FUNCTIONs and PROCEDUREs. callMethod tells the profiler when a
+ method is entered and left; run() does the same for the main program.
+
+ For each method it keeps the number of calls, inclusive time (counted once
+ for the outermost activation, so recursion is not added twice), exclusive
+ time (less the methods it called) and the deepest recursion seen. Exclusive
+ time is also kept per call stack, which writeFolded prints in the folded
+ stack format read by flamegraph tools ("main;f;g 1234", in microseconds).
+ */
+#ifndef CallProfiler_h
+#define CallProfiler_h
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class CallProfiler {
+private:
+    struct MethodStats {
+        string name;
+        long calls;
+        long long inclusiveNs; // outermost activations only
+        long long exclusiveNs;
+        int depth; // activations open right now
+        int maxDepth;
+    };
+    struct Frame {
+        int method; // index in methods
+        chrono::steady_clock::time_point start;
+        long long childNs; // inclusive time of the calls made from this frame
+    };
+    vector<MethodStats> methods; // index 0 is the main program
+    map<int, int> methodOfLine; // method heading line to index in methods
+    vector<Frame> frames; // the calls open right now, innermost last
+    vector<int> path; // methods of frames, the key into folded
+    map<vector<int>, long long> folded; // exclusive ns per call stack
+
+public:
+    CallProfiler();
+
+    // a call of the method whose heading is on line (-1 for the main program) starts
+    void enter(int line, string name);
+
+    // the innermost open call ends
+    void leave();
+
+    // print one row per method: calls, inclusive and exclusive ms and max depth, most exclusive time first
+    void report(ostream &out);
+
+    // print one line per call stack with its exclusive time in microseconds, rounded up to at least 1
+    void writeFolded(ostream &out);
+};
+
+#endif /* CallProfiler_h */
@@ -0,0 +1,401 @@
+//
+//  CompiledProgram.cpp
+//  MinusMinusV3
+//
+
+#include "CompiledProgram.h"
+#include <algorithm>
+#include "AllocationTracker.h"
+#include "ExecutionContext.h"
+
+CompiledProgram::CompiledProgram() {
+    size = loadErrors = 0;
+    for (int i = 0; i < SIZE; i++) {
+        lineCmd[i] = BLANK;
+        jump[i] = blockEnd[i] = -1;
+        lineBuiltin[i] = NO_BUILTIN;
+    }
+}
+
+/**
+ * @param inFile mm source code file
+ * @param list boolean directs to list the source code
+ * @param out where the listing and any errors go
+ * @post every line has its command worked out and SymbolTable 'methods' created.
+ * Errors found along the way are counted in loadErrors
+ * */
+bool CompiledProgram::loadProg(ifstream &inFile, bool list,
+                               ostream &out) // load the program using inFile given. Return true if successful else false
+{
+    AllocationScope phase(ALLOC_LOAD);
+    bool read = false;
+    string line;
+    Symbol s;
+    int temp;
+
+    if (inFile.fail())
+        out << "Could not open file" << endl;
+    else {
+        read = true;
+        while (!inFile.eof() && size < SIZE) {
+            getline(inFile, line);
+            temp = line.length();
+            if (temp > 0 && line[temp - 1] < ' ')
+                line[temp - 1] = ' '; // remove returns
+            progLine[size] = line;
+            size++;
+            if (list)
+                out << setw(3) << size << " " << line << endl;
+        }
+        ExecutionContext scanner(*this); // borrow the tokenizer and its error reporting
+        scanner.setErrorStream(out);
+        bool inMethod = false; // past the main program
+        for (int i = 0; i < size; i++) {
+            scanner = i + 1; // errors report the line being compiled
+            line = progLine[i];
+            lineCmd[i] = scanner.convertLine(line);
+            lineToken[i] *= scanner; // command token left by convertLine
+            lineRest[i] = line;
+            string method = scanner.nextToken(line, END_PAREN);
+            if (lineCmd[i] == FUNCTION) {
+                inMethod = true;
+                s = Symbol(method, i, FUNC);
+                methods.add(s);
+            } else if (lineCmd[i] == PROCEDURE) {
+                inMethod = true;
+                s = Symbol(method, i, PROC);
+                methods.add(s);
+            } else if (lineCmd[i] == FOR)
+                compileFor(i, scanner);
+            else if (lineCmd[i] == IF || lineCmd[i] == ELSEIF || lineCmd[i] == WHILE)
+                compileCondition(i, scanner);
+            else if (lineCmd[i] == GLOBAL)
+                compileGlobal(i, inMethod, scanner);
+        }
+        linkBlocks(scanner);
+        linkBuiltins();
+        loadErrors = scanner.getErrorCount();
+    }
+    return read;
+}
+
+/** findKeyword
+ input: s, word (upper case) and where to start looking
+ output: return where word starts in s as a word of its own, outside of quotes, parentheses
+ and brackets and in any case, string::npos if it is not there
+ */
+static size_t findKeyword(const string &s, string word, size_t from) {
+    int depth = 0;
+    bool quoted = false;
+    for (size_t i = from; i < s.length(); i++) {
+        char c = s[i];
+        if (c == '"')
+            quoted = !quoted;
+        else if (!quoted && (c == '(' || c == '['))
+            depth++;
+        else if (!quoted && (c == ')' || c == ']'))
+            depth--;
+        else if (!quoted && depth == 0 && toupper(c) == word[0] && (i == 0 || !isalnum(s[i - 1]))
+                 && s.length() - i >= word.length()) {
+            size_t end = i + word.length();
+            bool same = end == s.length() || !isalnum(s[end]);
+            for (size_t j = 1; same && j < word.length(); j++)
+                same = toupper(s[i + j]) == word[j];
+            if (same)
+                return i;
+        }
+    }
+    return string::npos;
+} // end findKeyword
+
+/** compileFor
+ input: lineNum of a FOR and the scanner compiling it
+ output: split FOR variable := from TO to [STEP step] into lineToken (the variable)
+ and forHeader, so running the FOR needs no tokenizing
+ changed: lineToken, forHeader and scanner's errors
+ */
+void CompiledProgram::compileFor(int lineNum, ExecutionContext &scanner) {
+    string rest = lineRest[lineNum];
+    size_t assign = rest.find(":=");
+    size_t to = assign == string::npos ? string::npos : findKeyword(rest, "TO", assign + 2);
+    size_t step = to == string::npos ? string::npos : findKeyword(rest, "STEP", to + 2);
+    if (to == string::npos) {
+        scanner.errorMsg("FOR needs variable := start TO end [STEP step]");
+        return;
+    }
+    string variable = rest.substr(0, assign);
+    ForHeader &header = forHeader[lineNum];
+    header.from = rest.substr(assign + 2, to - assign - 2);
+    header.to = step == string::npos ? rest.substr(to + 2) : rest.substr(to + 2, step - to - 2);
+    header.step = step == string::npos ? "" : rest.substr(step + 4);
+    scanner.trimIt(variable);
+    scanner.trimIt(header.from);
+    scanner.trimIt(header.to);
+    scanner.trimIt(header.step);
+    if (scanner.isValidID(variable) && (header.from == "" || header.to == ""
+                                        || (step != string::npos && header.step == "")))
+        scanner.errorMsg("FOR needs variable := start TO end [STEP step]");
+    lineToken[lineNum] = variable;
+} // end compileFor
+
+/** compileCondition
+ input: lineNum of an IF, ELSEIF or WHILE and the scanner compiling it
+ output: split the condition into comparisons joined by AND and OR, each maybe with
+ NOT in front, and split each comparison into its operands and operator
+ changed: condition and scanner's errors
+ */
+void CompiledProgram::compileCondition(int lineNum, ExecutionContext &scanner) {
+    string rest = lineRest[lineNum];
+    size_t start = 0;
+    while (start != string::npos) {
+        size_t andAt = findKeyword(rest, "AND", start);
+        size_t orAt = findKeyword(rest, "OR", start);
+        size_t end = min(andAt, orAt);
+        string text = rest.substr(start, end == string::npos ? string::npos : end - start);
+        Clause clause;
+        clause.orNext = end != string::npos && end == orAt;
+        size_t notAt = findKeyword(text, "NOT", 0);
+        clause.negate = notAt != string::npos && notAt == text.find_first_not_of(' ');
+        if (clause.negate)
+            text = text.substr(notAt + 3);
+        clause.left = scanner.nextToken(text, END_COMPARE); // as the tokenizer split a single compare
+        clause.op = scanner.nextToken(text, END_CMD);
+        clause.right = scanner.nextToken(text, END_LINE);
+        if (clause.left == "" || clause.right == "")
+            scanner.errorMsg("Missing comparison in condition");
+        else if (clause.op != "=" && clause.op != "<" && clause.op != ">" && clause.op != "<="
+                 && clause.op != ">=" && clause.op != "<>")
+            scanner.errorMsg("Invalid comparision operation of " + clause.op);
+        condition[lineNum].push_back(clause);
+        start = end == string::npos ? end : end + (clause.orNext ? 2 : 3);
+    }
+} // end compileCondition
+
+/** compileGlobal
+ input: lineNum of a GLOBAL, whether it is inside a method and the scanner compiling it
+ output: give each variable named a slot in the global area every run has. GLOBALs
+ belong to the main program and are found by every method, after its own variables
+ changed: globals and scanner's errors
+ */
+void CompiledProgram::compileGlobal(int lineNum, bool inMethod, ExecutionContext &scanner) {
+    string rest = lineRest[lineNum];
+    if (inMethod)
+        scanner.errorMsg("GLOBAL belongs in the main program, not in a FUNCTION or PROCEDURE");
+    while (rest != "") {
+        string name = scanner.nextToken(rest, END_COMMA);
+        string arrayName, index;
+        if (splitIndex(name, arrayName, index))
+            scanner.errorMsg("GLOBAL arrays are not supported: " + name);
+        else if (!scanner.isValidID(name))
+            ; // already reported
+        else if (globals.getSize() >= SYMBOLS_SIZE)
+            scanner.errorMsg("Too many GLOBALs");
+        else if (!globals.add(Symbol(name, globals.getSize(), VARIABLE)))
+            scanner.errorMsg("GLOBAL " + name + " declared twice");
+        if (rest != "" && scanner.nextToken(rest, END_COMMA) != ",")
+            scanner.errorMsg("Missing comma");
+    }
+} // end compileGlobal
+
+/** blockName
+ input: cmd that opens a block
+ output: the word that opens the block, for error messages
+ */
+static string blockName(Commands cmd) {
+    if (cmd == FOR)
+        return "FOR";
+    return cmd == WHILE ? "WHILE" : "IF";
+} // end blockName
+
+/** markBuiltins
+ input: s, part of a line that is run
+ output: return s with the name of each builtin called in it (name, maybe spaces, then "(")
+ swapped for BUILTIN_CALL and BUILTIN_ID_BASE + id, skipping quoted strings and the script's own methods
+ */
+string CompiledProgram::markBuiltins(const string &s) const {
+    string marked;
+    bool quoted = false;
+    size_t i = 0;
+    while (i < s.length()) {
+        if (s[i] == '"')
+            quoted = !quoted;
+        if (quoted || !isalpha(s[i]) || (i > 0 && isalnum(s[i - 1]))) {
+            marked += s[i++];
+            continue;
+        }
+        size_t end = i;
+        while (end < s.length() && isalnum(s[end]))
+            end++;
+        string name = s.substr(i, end - i);
+        size_t paren = s.find_first_not_of(' ', end);
+        BuiltinId id = paren != string::npos && s[paren] == '(' ? findBuiltin(name) : NO_BUILTIN;
+        Symbol method = Symbol(name, 0, NONE);
+        if (id != NO_BUILTIN && !getMethod(method)) {
+            marked += BUILTIN_CALL;
+            marked += (char) (BUILTIN_ID_BASE + id);
+        } else
+            marked += name;
+        i = end;
+    }
+    return marked;
+} // end markBuiltins
+
+/** linkBuiltins
+ output: give each CALL of a builtin its id and mark the builtin calls in the text of every
+ line that is run, so running them needs no name lookups
+ changed: lineBuiltin, lineToken, lineRest, forHeader and condition
+ */
+void CompiledProgram::linkBuiltins() {
+    for (int i = 0; i < size; i++) {
+        Commands cmd = lineCmd[i];
+        if (cmd == COMMENT || cmd == BLANK || cmd == FUNCTION || cmd == PROCEDURE || cmd == GLOBAL)
+            continue; // headings and GLOBALs have names, not calls
+        Symbol method = Symbol(lineToken[i], 0, NONE);
+        if (cmd == CALL && !getMethod(method))
+            lineBuiltin[i] = findBuiltin(lineToken[i]);
+        else if (cmd != CALL)
+            lineToken[i] = markBuiltins(lineToken[i]); // an array index or map key being set
+        lineRest[i] = markBuiltins(lineRest[i]);
+        ForHeader &header = forHeader[i];
+        header.from = markBuiltins(header.from);
+        header.to = markBuiltins(header.to);
+        header.step = markBuiltins(header.step);
+        for (int c = 0; c < condition[i].size(); c++) {
+            condition[i][c].left = markBuiltins(condition[i][c].left);
+            condition[i][c].right = markBuiltins(condition[i][c].right);
+        }
+    }
+} // end linkBuiltins
+
+/** linkBlocks
+ input: the scanner compiling the program
+ output: match up the blocks of every method and fill in jump and blockEnd:
+ FOR and ENDFOR point at each other, as do WHILE and ENDWHILE. IF, ELSEIF and ELSE
+ point at the next branch (or the ENDIF) and blockEnd of each is the ENDIF.
+ BREAK points at the end of its loop, CONTINUE at the WHILE or the ENDFOR (which steps).
+ Blocks left open, closed by the wrong command or closed twice are reported
+ changed: jump, blockEnd and scanner's errors
+ */
+void CompiledProgram::linkBlocks(ExecutionContext &scanner) {
+    vector<int> heads; // the IF, WHILE or FOR of each open block, innermost last
+    vector<int> branches; // the last IF, ELSEIF or ELSE of each (the head for loops)
+    for (int i = 0; i <= size; i++) {
+        Commands cmd = i < size ? lineCmd[i] : ENDPROGRAM;
+        scanner = i + 1;
+        Commands open = heads.empty() ? UNKNOWN : lineCmd[heads.back()];
+        if (cmd == FUNCTION || cmd == PROCEDURE || cmd == ENDPROGRAM) {
+            for (int j = 0; j < heads.size(); j++) {
+                scanner = heads[j] + 1;
+                scanner.errorMsg(blockName(lineCmd[heads[j]]) + " without END" + blockName(lineCmd[heads[j]]));
+            }
+            heads.clear();
+            branches.clear();
+        } else if (cmd == IF || cmd == WHILE || cmd == FOR) {
+            heads.push_back(i);
+            branches.push_back(i);
+        } else if ((cmd == ELSEIF || cmd == ELSE) && open != IF)
+            scanner.errorMsg(string(cmd == ELSE ? "ELSE" : "ELSEIF") + " without IF");
+        else if ((cmd == ELSEIF || cmd == ELSE) && lineCmd[branches.back()] == ELSE)
+            scanner.errorMsg(string(cmd == ELSE ? "ELSE" : "ELSEIF") + " after ELSE");
+        else if (cmd == ELSEIF || cmd == ELSE) {
+            jump[branches.back()] = i;
+            branches.back() = i;
+        } else if (cmd == ENDIF || cmd == ENDWHILE || cmd == ENDFOR) {
+            Commands head = cmd == ENDIF ? IF : cmd == ENDWHILE ? WHILE : FOR;
+            if (open != head) {
+                scanner.errorMsg("END" + blockName(head) + " without " + blockName(head));
+                continue;
+            }
+            jump[branches.back()] = i;
+            for (int line = heads.back(); line != i; line = jump[line])
+                blockEnd[line] = i;
+            jump[i] = heads.back();
+            heads.pop_back();
+            branches.pop_back();
+        } else if (cmd == BREAK || cmd == CONTINUE) {
+            int loop = heads.size() - 1; // the innermost loop, IFs in between do not count
+            while (loop >= 0 && lineCmd[heads[loop]] == IF)
+                loop--;
+            if (loop < 0)
+                scanner.errorMsg(string(cmd == BREAK ? "BREAK" : "CONTINUE") + " outside of a loop");
+            else
+                jump[i] = heads[loop]; // until its end is known
+        }
+    }
+    for (int i = 0; i < size; i++) { // BREAK: the end of its loop, CONTINUE: the WHILE or the ENDFOR
+        if ((lineCmd[i] == BREAK || lineCmd[i] == CONTINUE) && jump[i] >= 0) {
+            int loop = jump[i];
+            jump[i] = lineCmd[i] == CONTINUE && lineCmd[loop] == WHILE ? loop : blockEnd[loop];
+        }
+    }
+} // end linkBlocks
+
+int CompiledProgram::getSize() const {
+    return size;
+}
+
+int CompiledProgram::getLoadErrors() const {
+    return loadErrors;
+}
+
+bool CompiledProgram::getMethod(Symbol &s) const {
+    return methods.get(s);
+}
+
+const string &CompiledProgram::getLine(int lineNum) const {
+    return progLine[lineNum];
+}
+
+Commands CompiledProgram::getCommand(int lineNum) const {
+    return lineCmd[lineNum];
+}
+
+const string &CompiledProgram::getToken(int lineNum) const {
+    return lineToken[lineNum];
+}
+
+const string &CompiledProgram::getRest(int lineNum) const {
+    return lineRest[lineNum];
+}
+
+bool CompiledProgram::getGlobal(Symbol &s) const {
+    return globals.get(s);
+}
+
+int CompiledProgram::getGlobalCount() const {
+    return globals.getSize();
+}
+
+int CompiledProgram::getJump(int lineNum) const {
+    return jump[lineNum];
+}
+
+int CompiledProgram::getBlockEnd(int lineNum) const {
+    return blockEnd[lineNum];
+}
+
+const ForHeader &CompiledProgram::getForHeader(int lineNum) const {
+    return forHeader[lineNum];
+}
+
+BuiltinId CompiledProgram::getBuiltin(int lineNum) const {
+    return lineBuiltin[lineNum];
+}
+
+const vector<Clause> &CompiledProgram::getCondition(int lineNum) const {
+    return condition[lineNum];
+}
+
+/** getMethodName
+ input: lineNum, the heading of a FUNCTION or PROCEDURE
+ output: return the method name, the heading up to its parameters
+ */
+string CompiledProgram::getMethodName(int lineNum) const {
+    string rest = lineRest[lineNum];
+    size_t paren = rest.find('(');
+    if (paren != string::npos)
+        rest = rest.substr(0, paren);
+    size_t first = rest.find_first_not_of(' ');
+    size_t last = rest.find_last_not_of(' ');
+    return first == string::npos ? "?" : rest.substr(first, last - first + 1);
+} // end getMethodName
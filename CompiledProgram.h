@@ -0,0 +1,127 @@
+//
+//  CompiledProgram.h
+//  MinusMinusV3
+//
+/*
+--------------------------------------------------
+                  CompiledProgram
+--------------------------------------------------
+ -progLine[SIZE]:string
+ -lineCmd[SIZE]:Commands
+ -lineToken[SIZE]:string
+ -lineRest[SIZE]:string
+ -jump[SIZE]:integer
+ -blockEnd[SIZE]:integer
+ -forHeader[SIZE]:ForHeader
+ -condition[SIZE]:vector of Clause
+ -lineBuiltin[SIZE]:BuiltinId
+ -methods:SymbolTable
+ -globals:SymbolTable
+ -size:integer
+ -loadErrors:integer
+--------------------------------------------------
+ +loadProg(inFile:ifstream, list:bool, out:ostream):bool // load and compile the program, listing and errors to out. Return true if file read
+ +getSize():integer // number of program lines
+ +getLoadErrors():integer // errors found while compiling
+ +getMethod(s:Symbol):bool // look up a function or procedure
+ +getGlobal(s:Symbol):bool // look up a GLOBAL variable, its offset is its slot
+ +getGlobalCount():integer // slots a run needs for the GLOBAL variables
+ +getLine(lineNum:integer):string // source text of a line
+ +getCommand(lineNum:integer):Commands // command decided at load time
+ +getToken(lineNum:integer):string // command token (the identifier for ASSIGN and CALL)
+ +getRest(lineNum:integer):string // line with the command token chopped off
+ +getMethodName(lineNum:integer):string // name of the method headed on a line
+ +getJump(lineNum:integer):integer // matching line of a block command, -1 if none
+ +getBlockEnd(lineNum:integer):integer // the ENDIF, ENDWHILE or ENDFOR closing a block command
+ +getForHeader(lineNum:integer):ForHeader // start, end and step expressions of a FOR
+ +getCondition(lineNum:integer):vector of Clause // comparisons of an IF, ELSEIF or WHILE
+ +getBuiltin(lineNum:integer):BuiltinId // builtin a CALL line runs, NO_BUILTIN if none
+--------------------------------------------------
+ Holds everything learned from the source file. Once loadProg returns, nothing
+ in the object changes, so one CompiledProgram can be shared by any number of
+ ExecutionContexts, including ones running on different threads.
+ */
+#ifndef CompiledProgram_h
+#define CompiledProgram_h
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "Builtins.h"
+#include "SymbolTable.h"
+
+using namespace std;
+
+enum Commands {
+    ASSIGN, BREAK, CALL, COMMENT, BLANK, CONTINUE, DECLARE, ELSE, ELSEIF, ENDFOR, ENDIF, ENDWHILE,
+    ENDPROGRAM, FOR, FUNCTION, GLOBAL, IF, INPUT, PRINT, PRINTLN, PROCEDURE, RETURN, UNKNOWN, WHILE
+};
+
+const int SIZE = 500;
+
+// FOR variable := from TO to STEP step, split up at load time (the variable is the line's token)
+struct ForHeader {
+    string from;
+    string to;
+    string step; // "" for a step of 1
+};
+
+// one comparison of an IF, ELSEIF or WHILE condition, split up at load time
+struct Clause {
+    string left;
+    string op; // =, <, >, <=, >= or <>
+    string right;
+    bool negate; // NOT in front
+    bool orNext; // OR joins it to the next clause, else AND (which binds tighter)
+};
+
+class ExecutionContext;
+
+class CompiledProgram {
+private:
+    string progLine[SIZE]; // array holds program lines
+    Commands lineCmd[SIZE]; // command of each line
+    string lineToken[SIZE]; // command token of each line
+    string lineRest[SIZE]; // each line after the command token
+    int jump[SIZE]; // loops: their end, IF branches: the next branch or ENDIF, ends: their head,
+                    // BREAK and CONTINUE: where they go, else -1
+    int blockEnd[SIZE]; // the line closing the block headed (or continued) on each line, else -1
+    ForHeader forHeader[SIZE]; // parts of each FOR line
+    vector<Clause> condition[SIZE]; // clauses of each IF, ELSEIF and WHILE line
+    BuiltinId lineBuiltin[SIZE]; // builtin run by each CALL line, NO_BUILTIN for a method or other command
+    SymbolTable methods; // for the functions and procedures
+    SymbolTable globals; // GLOBAL variables, offset is the slot of each in a run's global area
+    int size;
+    int loadErrors;
+
+    void compileFor(int lineNum, ExecutionContext &scanner); // split up the FOR on lineNum
+    void compileCondition(int lineNum, ExecutionContext &scanner); // split the condition on lineNum into clauses
+    void compileGlobal(int lineNum, bool inMethod, ExecutionContext &scanner); // give the GLOBALs on lineNum slots
+    void linkBlocks(ExecutionContext &scanner); // match up block commands and fill in jump and blockEnd
+    string markBuiltins(const string &s) const; // s with each builtin call's name swapped for its id
+    void linkBuiltins(); // resolve the builtins called on every line, once all the methods are known
+
+public:
+    CompiledProgram();
+
+    bool loadProg(ifstream &inFile, bool list,
+                  ostream &out = cout); // load the program using inFile given. Return true if successful else false
+    int getSize() const; // number of program lines
+    int getLoadErrors() const; // number of errors found while compiling
+    bool getMethod(Symbol &s) const; // looks for method named in Symbol s and, if found, fills in offset and type in s
+    bool getGlobal(Symbol &s) const; // looks for GLOBAL named in Symbol s and, if found, fills in its slot and type
+    int getGlobalCount() const; // number of GLOBAL variables
+    const string &getLine(int lineNum) const; // source text of lineNum
+    Commands getCommand(int lineNum) const; // command of lineNum
+    const string &getToken(int lineNum) const; // command token of lineNum
+    const string &getRest(int lineNum) const; // lineNum with the command token removed
+    string getMethodName(int lineNum) const; // name of the FUNCTION or PROCEDURE headed on lineNum
+    int getJump(int lineNum) const; // line matching the block command on lineNum, -1 if none
+    int getBlockEnd(int lineNum) const; // line closing the block command on lineNum, -1 if none
+    const ForHeader &getForHeader(int lineNum) const; // start, end and step of the FOR on lineNum
+    const vector<Clause> &getCondition(int lineNum) const; // clauses of the condition on lineNum
+    BuiltinId getBuiltin(int lineNum) const; // builtin run by the CALL on lineNum, NO_BUILTIN if none
+};
+
+#endif /* CompiledProgram_h */
@@ -0,0 +1,948 @@
+//
+//  ExecutionContext.cpp
+//  MinusMinusV3
+//
+//  Created by Tony Biehl on 2/13/21.
+//  Copyright © 2021 Tony Biehl. All rights reserved.
+//
+
+#include "ExecutionContext.h"
+#include "support.hpp"
+
+ExecutionContext::ExecutionContext(const CompiledProgram &program, unsigned int seed)
+        : prog(program), globals(program.getGlobalCount(), 0), random(seed) {
+    lineNumber = errorCount = 0;
+    statementCount = 0;
+    quantum = sliceLeft = 0;
+    yieldHook = NULL;
+    yieldArg = NULL;
+    limited = hasDeadline = limitExceeded = false;
+    maxStatements = 0;
+    ticksLeft = LIMIT_CLOCK_TICKS;
+    lineProfiler = NULL;
+    callProfiler = NULL;
+    sampler = NULL;
+    tracer = NULL;
+    command = UNKNOWN;
+    in = &cin;
+    out = err = &cout;
+}
+
+bool ExecutionContext::addParmOffset(string parmName, int offset,
+                            SymbolTable &localVars) // add the parameter to the local vars and attach the offset to the stack to it
+{
+    int tos = stack.getStackSize() - 1; // get actual top of stack
+    Symbol parm = Symbol(parmName, tos - offset, VARIABLE); // set parm to actual index in stack
+    return localVars.add(parm); // add the parm
+}
+
+/** checkFirstChar
+ input: s and ch
+ output: check to make sure string s is not empty then check if first character of s is equal to ch
+ (return true if so, else false). This prevents crashes
+ */
+bool checkFirstChar(string s, char ch) {
+    return (s.length() > 0 && s[0] == ch);
+} // end checkFirstChar
+
+/** splitSubscript
+ input: s, the open and close characters of a subscript, name and subscript
+ output: if s is name followed by a subscript between open and close, fill in name
+ (trimmed) and subscript and return true, else return false
+ changed: name and subscript
+ */
+static bool splitSubscript(string s, char open, char close, string &name, string &subscript) {
+    size_t start = s.find_first_of("[{");
+    if (start == string::npos || s[start] != open)
+        return false;
+    size_t end = s.find_last_of(close);
+    if (end == string::npos || end < start)
+        end = s.length(); // missing close, element() or the key's parse reports it
+    name = s.substr(0, start);
+    subscript = s.substr(start + 1, end - start - 1);
+    while (!name.empty() && name[name.length() - 1] == ' ')
+        name.erase(name.length() - 1);
+    return true;
+} // end splitSubscript
+
+/** splitIndex
+ input: s, name and index
+ output: if s is an indexed array element, name[index], fill in name and index (trimmed)
+ and return true, else return false
+ changed: name and index
+ */
+bool splitIndex(string s, string &name, string &index) {
+    return splitSubscript(s, '[', ']', name, index);
+} // end splitIndex
+
+/** splitKey
+ input: s, name and key
+ output: if s is a map entry, name{key}, fill in name and key and return true, else return false
+ changed: name and key
+ */
+bool splitKey(string s, string &name, string &key) {
+    return splitSubscript(s, '{', '}', name, key);
+} // end splitKey
+
+
+
+/** chop
+ input: str and x
+ output: chop string by keeping string str from x to the end of the line
+ changed: str
+ */
+void chop(string &str, int x) {
+    if (x < str.length())
+        str = str.substr(x, str.length());
+    else
+        str = "";
+} // end chop
+
+/**
+ * @return one of Commands enums
+ * */
+Commands ExecutionContext::convertLine(string &c) {
+    command = UNKNOWN;
+    string cmdText = nextToken(c, END_CMD), name, index;
+    trim(SPACES, cmdText);
+    trim(SPACES, c);
+    for (int i = 0; i < cmdText.length(); i++)
+        cmdText[i] = toupper(cmdText[i]);
+    if (cmdText == "")
+        command = BLANK;
+    else if (cmdText.length() > 0 && cmdText[0] == ';')
+        command = COMMENT;
+    else if (cmdText == "BREAK")
+        command = BREAK;
+    else if (cmdText == "CONTINUE")
+        command = CONTINUE;
+    else if (cmdText == "DECLARE")
+        command = DECLARE;
+    else if (cmdText == "ELSE")
+        command = ELSE;
+    else if (cmdText == "ELSEIF")
+        command = ELSEIF;
+    else if (cmdText == "ENDFOR")
+        command = ENDFOR;
+    else if (cmdText == "ENDIF")
+        command = ENDIF;
+    else if (cmdText == "ENDWHILE")
+        command = ENDWHILE;
+    else if (cmdText == "FOR")
+        command = FOR;
+    else if (cmdText == "FUNCTION")
+        command = FUNCTION;
+    else if (cmdText == "GLOBAL")
+        command = GLOBAL;
+    else if (cmdText == "IF")
+        command = IF;
+    else if (cmdText == "INPUT")
+        command = INPUT;
+    else if (cmdText == "PRINT")
+        command = PRINT;
+    else if (cmdText == "PRINTLN")
+        command = PRINTLN;
+    else if (cmdText == "PROCEDURE")
+        command = PROCEDURE;
+    else if (cmdText == "RETURN")
+        command = RETURN;
+    else if (cmdText == "WHILE")
+        command = WHILE;
+    else if (cmdText.length() > 0
+             && isValidID(splitIndex(cmdText, name, index) || splitKey(cmdText, name, index) ? name : cmdText)) {
+        if (c.length() > 1 && (c.substr(0, 2) == ":=" || (c[1] == '=' && isOperator(c.substr(0, 1)))))
+            command = ASSIGN; // := or one of += -= *= /= %=
+        else if (c[0] == '(')
+            command = CALL;
+    }
+    return command;
+}
+
+
+/** countArguments
+ input: table SymbolTable, parameters passed via s (in parenthesis),
+ and boolean zero for just putting on zeros onto stack and not calculated values
+ output: take every argument in s and either put a zero onto the stack or push the parsed value
+ changed: s and stack
+ */
+int ExecutionContext::countArguments(SymbolTable &localVars, string &s) {
+    int count = 0;
+    string temp;
+    bool success;
+    trim(PARENTHESIS, s);
+    while (s != "") // count the parameters
+    {
+        temp = nextToken(s, END_COMMA); // get parameter
+        push(parseEquation(*this, temp, localVars, success)); // save on stack
+        count++; //
+        if (s != "" && nextToken(s, END_COMMA) != ",")
+            errorMsg("Missing comma");
+    }
+    return count;
+} // end countArguments
+
+
+/** errorMsg
+ input: msg for the error message
+ output: print lineNum and error and count it via errorCount.
+ Return false for convenience
+ changed: errorCount
+ */
+bool ExecutionContext::errorMsg(string msg) {
+    // assume lineNumber pointing one past line with error
+    *err << "Error at line " << lineNumber << ": " << msg << endl;
+    errorCount++;
+    return false;
+} // end errorMsg
+
+int ExecutionContext::getErrorCount() {
+    return errorCount;
+}
+
+int ExecutionContext::getLineNumber() {
+    return lineNumber;
+}
+
+string ExecutionContext::getLine() {
+    return line;
+}
+
+void ExecutionContext::setLine(string rest) {
+    line = rest;
+}
+
+const CompiledProgram &ExecutionContext::getProgram() {
+    return prog;
+}
+
+bool ExecutionContext::getMethod(Symbol &s) {
+    return prog.getMethod(s);
+}
+
+int ExecutionContext::getStackSize() {
+    return stack.getStackSize();
+}
+
+long ExecutionContext::getStatementCount() {
+    return statementCount;
+}
+
+RunStats &ExecutionContext::getStats() {
+    stats.lines = statementCount;
+    return stats;
+}
+
+CallProfiler *ExecutionContext::getCallProfiler() {
+    return callProfiler;
+}
+
+void ExecutionContext::setCallProfiler(CallProfiler *profiler) {
+    callProfiler = profiler;
+}
+
+SamplingProfiler *ExecutionContext::getSampler() {
+    return sampler;
+}
+
+void ExecutionContext::setSampler(SamplingProfiler *profiler) {
+    sampler = profiler;
+}
+
+Tracer *ExecutionContext::getTracer() {
+    return tracer;
+}
+
+void ExecutionContext::setTracer(Tracer *t) {
+    tracer = t;
+}
+
+LineProfiler *ExecutionContext::getLineProfiler() {
+    return lineProfiler;
+}
+
+void ExecutionContext::setLineProfiler(LineProfiler *profiler) {
+    lineProfiler = profiler;
+}
+
+bool ExecutionContext::isLimitExceeded() {
+    return limitExceeded;
+}
+
+istream &ExecutionContext::getIn() {
+    return *in;
+}
+
+ostream &ExecutionContext::getOut() {
+    return *out;
+}
+
+/** nextRandom
+ output: next value of this context's random sequence, in the same 0 to RAND_MAX range as rand()
+ changed: random
+ */
+int ExecutionContext::nextRandom() {
+    return (int) (random() % ((unsigned long) RAND_MAX + 1));
+} // end nextRandom
+
+void ExecutionContext::seed(unsigned int s) {
+    random.seed(s);
+}
+
+void ExecutionContext::setErrorStream(ostream &e) {
+    err = &e;
+}
+
+void ExecutionContext::setIO(istream &i, ostream &o) {
+    in = &i;
+    out = &o;
+}
+
+/** setQuantum
+ input: lines, hook and arg
+ output: from now on operator++ calls hook(arg) once every lines lines. The hook may switch
+ to another fiber; the run carries on where it was when the hook returns. lines of 0 turns it off
+ changed: quantum, sliceLeft, yieldHook and yieldArg
+ */
+void ExecutionContext::setQuantum(int lines, void (*hook)(void *), void *arg) {
+    quantum = sliceLeft = hook != NULL && lines > 0 ? lines : 0;
+    yieldHook = hook;
+    yieldArg = arg;
+} // end setQuantum
+
+/** setLimits
+ input: statements and deadlineMs (0 for no limit)
+ output: the run is stopped with an error once it has dispatched more than statements
+ lines or deadlineMs milliseconds from now have gone by. The limits are only checked
+ by tick(), which execute calls at backward jumps and calls
+ changed: limits
+ */
+void ExecutionContext::setLimits(long statements, long deadlineMs) {
+    maxStatements = statements > 0 ? statements : 0;
+    hasDeadline = deadlineMs > 0;
+    if (hasDeadline)
+        deadline = chrono::steady_clock::now() + chrono::milliseconds(deadlineMs);
+    limited = maxStatements > 0 || hasDeadline;
+    ticksLeft = LIMIT_CLOCK_TICKS;
+} // end setLimits
+
+/** tick
+ output: at a backward jump or call (the only ways a run can go on forever) check the
+ statement limit, and the deadline every LIMIT_CLOCK_TICKS ticks. Return false and
+ stop the run with an error once a limit is passed
+ changed: ticksLeft, limitExceeded and errorCount
+ */
+bool ExecutionContext::tick() {
+    if (!limited || limitExceeded)
+        return !limitExceeded;
+    if (maxStatements > 0 && statementCount > maxStatements) {
+        limitExceeded = true;
+        errorMsg("Statement limit of " + to_string(maxStatements) + " exceeded");
+    } else if (hasDeadline && --ticksLeft <= 0) {
+        ticksLeft = LIMIT_CLOCK_TICKS;
+        if (chrono::steady_clock::now() > deadline) {
+            limitExceeded = true;
+            errorMsg("Deadline exceeded");
+        }
+    }
+    return !limitExceeded;
+} // end tick
+
+/** isOperator
+ input: string s as a math operator
+ output: check if math operator (true if operator, else false)
+ */
+bool ExecutionContext::isOperator(string s) {
+    if (s == "+" || s == "-" || s == "*" || s == "/" || s == "%")
+        return true;
+    return false;
+} // end isOperator
+
+/** isValidID
+ input: string id
+ output: will check id and return true if valid id else false (and generate any needed errors)
+ changed: number of errors
+ */
+bool ExecutionContext::isValidID(string id) {
+    bool valid = true;
+    if (id.length() == 0) {
+        errorMsg("blank ID");
+        valid = false;
+    } else if (!isalpha(id[0])) {
+        errorMsg("ID " + id + " must start with a letter");
+        valid = false;
+    }
+    for (int x = 1; valid && x < id.length(); x++) {
+        if (!isalnum(id[x])) {
+            errorMsg("Invalid character in identifier of " + id);
+            valid = false;
+        }
+    }
+    return valid;
+} // end isValidID
+
+
+void ExecutionContext::operator=(int lineNum) // goto lineNum
+{
+    lineNumber = lineNum;
+}
+
+Commands ExecutionContext::operator++() // next line and return the command
+{
+    Commands cmd = UNKNOWN;
+    if (quantum > 0 && --sliceLeft == 0) { // slice used up, let something else run
+        sliceLeft = quantum;
+        currentStats = NULL; // whatever runs next on this thread is not ours
+        yieldHook(yieldArg);
+        currentStats = &stats;
+    }
+    if (lineNumber >= prog.getSize()) {
+        command = cmd = ENDPROGRAM;
+    } else if (errorCount == 0) { // command was worked out by loadProg
+        command = cmd = prog.getCommand(lineNumber);
+        lastToken = prog.getToken(lineNumber);
+        line = prog.getRest(lineNumber);
+        if (sampler != NULL)
+            sampler->atLine(lineNumber);
+        lineNumber++;
+        statementCount++;
+    } else { // stopped, possibly while yielding, so nothing is left to run
+        command = cmd;
+        lastToken = line = "";
+    }
+    return cmd;
+}
+
+string ExecutionContext::operator-=(Extract e) // get next token
+{
+    switch (e) {
+        case BOOLEAN:
+            return nextToken(line, END_COMPARE);
+        case CMD:
+            return nextToken(line, END_CMD);
+        case COMMA:
+            return nextToken(line, END_COMMA);
+        case COMPARE:
+            return nextToken(line, END_COMPARE);
+        case EQUATION:
+        case LINE:
+            return nextToken(line, END_LINE);
+        case PARMS:
+            trim(PARENTHESIS, line);
+            return "(";
+        case OPEN_PARM:
+            return nextToken(line, END_PAREN);
+        case STRING:
+        case TOKEN:
+            return nextToken(line, END_SPACE);
+    }
+    return " ";
+}
+
+bool ExecutionContext::operator==(string method) // see if valid function or procedure
+{
+    Symbol temp = Symbol(method, 0, NONE);
+    if (prog.getMethod(temp))
+        return true;
+    return false;
+}
+
+Commands &operator*=(Commands &c, ExecutionContext &p) // friend operator to get the command
+{
+    c = p.command;
+    return c;
+}
+
+string &operator*=(string &s, ExecutionContext &p) // friend operator to get the last token
+{
+    s = p.lastToken;
+    //cout << "lastToken " << s << endl;
+    return s;
+}
+
+int &operator*=(int &offset, ExecutionContext &p) // friend operator to get the item on stack via offset
+{
+    bool success;
+    offset = p.stack.peek(offset, success);
+    if (!success)
+        p.errorMsg("Stack access out of range");
+    return offset;
+}
+
+/** nextFactor
+ input: s with an equation to get the next part (factor) of
+ output: get next factor of an equation: operator, literal, variable or function call and return that.
+ With function call, FUNCTION_ARG (~) is appended to the front (for parseEquation) for easier recognition
+ changed: s
+ */
+string ExecutionContext::nextFactor(string &s) {
+    stats.factors++;
+    string temp = "";
+    int x = 0;
+    bool endFactor = false;
+    bool variable = false;
+    trimIt(s);
+    // check for operator
+    if (s.length() > 0
+        && (s[x] == '(' || s[x] == '*' || s[x] == '/' || s[x] == '+' || s[x] == '-' || s[x] == '%' || s[x] == ')')) {
+        temp += s[x];
+        endFactor = true;
+        x++;
+    } else if (s.length() > 1 && s[x] == BUILTIN_CALL) { // a builtin loadProg found, marker and id for its name
+        temp = s.substr(0, 2);
+        endFactor = variable = true;
+        x = 2;
+    }
+    if (!endFactor && s.length() > x) { // check for variable or literal
+        if (isalpha(s[x]))
+            variable = true;
+        while (!endFactor && s.length() > x) {
+            if (!variable && isdigit(s[x])) {
+                temp += s[x];
+                x++;
+            } else if (variable && isalnum(s[x])) {
+                temp += s[x];
+                x++;
+            } else
+                endFactor = true;
+        }
+    }
+    s = s.substr(x);
+    trimIt(s);
+    if (variable && (checkFirstChar(s, '[') || checkFirstChar(s, '{'))) { // array element or map entry, keep the subscript
+        char open = s[0];
+        char close = open == '[' ? ']' : '}';
+        x = 0;
+        int countBrackets = 0;
+        do {
+            temp += s[x];
+            if (s[x] == close)
+                countBrackets--;
+            else if (s[x] == open)
+                countBrackets++;
+            x++;
+        } while (s.length() > x && countBrackets > 0);
+        if (countBrackets > 0)
+            errorMsg(open == '[' ? "Missing ] in array index" : "Missing } in map key");
+        s = s.substr(x);
+    } else if (variable && checkFirstChar(s, '(')) { // a function! Get the entire function call
+        x = 0; // reset x
+        int countPar = 0; // count open parentheis
+        do {
+            temp += s[x];
+            if (s[x] == ')')
+                countPar--;
+            else if (s[x] == '(')
+                countPar++;
+            x++;
+        } while (s.length() > x && countPar > 0);
+        if (countPar > 0)
+            errorMsg("Missing end ) to function call");
+        s = s.substr(x);
+        temp = FUNCTION_ARG + temp;
+    }
+    return temp;
+} // end nextFactor
+
+/** nextToken
+ input: s, endCH, variable char, defaults to ' '
+ if END_CMD ('^'), get chars until either a open parenthsis or space
+ if END_COMMA (','), get chars until a comma is reached
+ Note: if only a comma then the comma is returned
+ Also note: if a comma is in parenthesis (like a function) routine keeps going
+ if END_LINE ('~'), gets the rest of the line and empties line
+ if END_COMPARE ('='), gets chars until a compare operator hit
+ if END_PAREN ('('), gets chars until a open parenthesis operator hit
+ if a double quote then get entire string
+ output: returns extracted string from s and sets to currentToken and chops s
+ changed: s and currentToken (access that by token function)
+ */
+string ExecutionContext::nextToken(string &s, char endCH) {
+    stats.tokens++;
+    string temp = "";
+    int x = 0;
+    int numParens = 0;
+    int numBrackets = 0; // an array index or map key is part of the token, spaces and all
+    bool endToken = false;
+    bool endCall = false;
+    trim(SPACES, s);
+    //cout << "nextToken start |" << s << "|\n";
+    if (endCH == END_LINE) { // get the rest of the line
+        temp = s;
+        s = "";
+    } else if (endCH == END_CMD) {
+        endCH = END_SPACE;
+        endCall = true; // do end parenthesis AND space
+    }
+    if (s.length() > 0) {
+        if (checkFirstChar(s, '"') && endCH == ' ')
+            endCH = '"';
+        while (!endToken && x < s.length()) {
+            char ch = s[x];
+            if (ch == '\t') {
+                ch = ' ';
+                temp += "   ";
+            }
+            if (ch == '[' || ch == '{' || ((ch == ']' || ch == '}') && numBrackets > 0)) {
+                numBrackets += ch == '[' || ch == '{' ? 1 : -1;
+                temp += ch;
+            } else if (numBrackets > 0) {
+                temp += ch;
+            } else if (endCH == END_COMPARE && (ch == '<' || ch == '=' || ch == '>')) {
+                endToken = true;
+            } else if ((endCH == END_PAREN || endCall) && ch == '(') {
+                endToken = true;
+            } else if (ch == '"') {
+                temp += ch; // have a string, get it
+                x++;
+                while (x < s.length() && s[x] != '"') {
+                    temp += s[x];
+                    x++;
+                }
+                temp += s[x]; // final quote
+            } else if (endCH == ch) {
+                if (endCH == END_COMMA) {
+                    if (x == 0) {
+                        temp += ch; // comma is the token
+                        x++; // remove it
+                        endToken = true;
+                    } else if (numParens > 0)
+                        temp += ch; // comma part of a function call
+                    else
+                        endToken = true; // command ends the token
+                } else
+                    endToken = true; // must be END_SPACE
+            } else {
+                // allow function calls to be one unit (skip their commas)
+                if (ch == '(')
+                    numParens++;
+                else if (ch == ')')
+                    numParens--;
+                temp += ch;
+                if (endCH == ch)
+                    endToken = true;
+            }
+            if (!endToken)
+                x++;
+        } // end while
+        if (numParens > 0)
+            errorMsg("Parenthesis mismatch");
+        s = s.substr(x);
+    } // end if
+    //cout << "nextToken end with s |" << s << "| and temp |" << temp << "|\n";
+    lastToken = temp; // save a copy of the token
+    return temp;
+} // end nextToken
+
+
+int ExecutionContext::peek() // get a copy of top of stack
+{
+    return stack.peek();
+}
+
+int ExecutionContext::peek(string v,
+                  SymbolTable &localVars) // get a copy of the value of local variable (localVars points to correct place on stack)
+{
+    bool success = false;
+    int result = 0;
+    Symbol sym = Symbol(v, 0, NONE);
+    if (!localVars.get(sym)) {
+        int *value = global(v);
+        if (value == NULL)
+            errorMsg(v + " variable not found");
+        return value == NULL ? 0 : *value;
+    } else if (sym.getType() != VARIABLE)
+        errorMsg(v + " is not a variable");
+    else
+        result = stack.peek(sym.getOffset(), success);
+    if (!success)
+        errorMsg("Could not access correct variable offset in stack");
+    return result;
+}
+
+int ExecutionContext::peek(int i) // know which offset on stack you want
+{
+    bool success = false;
+    int val = stack.peek(i, success);
+    if (!success)
+        errorMsg("Could not access correct index in stack");
+    return val;
+}
+
+void ExecutionContext::pop(int x) // pop last x items from stack
+{
+    if (!stack.pop(x))
+        errorMsg("Tried to pop too many values from stack");
+}
+
+/** precedence
+ return precedence of three operators (*, /, % have precedence of 1, all others precedence of 0)
+ */
+int ExecutionContext::precedence(string s) {
+    int pred = 0;
+    if (s == "*" || s == "/" || s == "%")
+        pred = 1;
+    return pred;
+} // end precedence
+
+void ExecutionContext::push(int line) // push current line onto stack
+{
+    if (!stack.push(line)) {
+        errorMsg("Stack overflow");
+        return;
+    }
+    stats.pushes++;
+    if (stack.getStackSize() > stats.stackHighWater)
+        stats.stackHighWater = stack.getStackSize();
+}
+
+bool
+ExecutionContext::push(string v, SymbolTable &localVars) // push local variable space onto stack and add variable to localVars
+{
+    int next = stack.getStackSize(); // get next available space on stack
+    Symbol var = Symbol(v, next, VARIABLE);
+    if (!localVars.add(var))
+        return false; // already declared, keep the old space
+    push(0);
+    return true;
+}
+
+/** pushArray
+ input: v, size and localVars
+ output: add array v to localVars with a stack slot holding the index of a new buffer of size
+ zeros. Return false if v is already declared or size is not 1 to ARRAY_MAX (with an error)
+ changed: arrays, stack and localVars
+ */
+bool ExecutionContext::pushArray(string v, int size, SymbolTable &localVars) {
+    if (size < 1 || size > ARRAY_MAX) {
+        errorMsg("Array size of " + to_string(size) + " for " + v + " must be 1 to " + to_string(ARRAY_MAX));
+        return false;
+    }
+    Symbol var = Symbol(v, stack.getStackSize(), ARRAY);
+    if (!localVars.add(var))
+        return false; // already declared, keep the old array
+    push((int) arrays.size());
+    arrays.push_back(vector<int>(size, 0));
+    return true;
+} // end pushArray
+
+/** array
+ input: v and localVars
+ output: return the buffer of array v, NULL (and an error) if v is not an array
+ */
+vector<int> *ExecutionContext::array(string v, SymbolTable &localVars) {
+    Symbol sym = Symbol(v, 0, NONE);
+    if (!localVars.get(sym)) {
+        errorMsg(v + (global(v) != NULL ? " is not an array" : " array not found"));
+        return NULL;
+    }
+    if (sym.getType() != ARRAY) {
+        errorMsg(v + " is not an array");
+        return NULL;
+    }
+    bool success;
+    int handle = stack.peek(sym.getOffset(), success);
+    if (!success || handle < 0 || handle >= arrays.size()) {
+        errorMsg("Could not access array " + v);
+        return NULL;
+    }
+    return &arrays[handle];
+} // end array
+
+/** element
+ input: v, index and localVars
+ output: return the address of element index of array v, NULL (and an error) if v is not an
+ array or index is out of bounds
+ */
+int *ExecutionContext::element(string v, int index, SymbolTable &localVars) {
+    vector<int> *values = array(v, localVars);
+    if (values == NULL)
+        return NULL;
+    if (index < 0 || index >= values->size()) {
+        errorMsg("Index " + to_string(index) + " out of bounds for " + v + "[" + to_string(values->size()) + "]");
+        return NULL;
+    }
+    return &(*values)[index];
+} // end element
+
+/** pushMap
+ input: v and localVars
+ output: add map v to localVars with a stack slot holding the index of a new empty map.
+ Return false if v is already declared
+ changed: maps, stack and localVars
+ */
+bool ExecutionContext::pushMap(string v, SymbolTable &localVars) {
+    Symbol var = Symbol(v, stack.getStackSize(), MAP);
+    if (!localVars.add(var))
+        return false; // already declared, keep the old map
+    push((int) maps.size());
+    maps.push_back(IntMap());
+    return true;
+} // end pushMap
+
+/** map
+ input: v and localVars
+ output: return map v, NULL (and an error) if v is not a map
+ */
+IntMap *ExecutionContext::map(string v, SymbolTable &localVars) {
+    Symbol sym = Symbol(v, 0, NONE);
+    if (!localVars.get(sym)) {
+        errorMsg(v + (global(v) != NULL ? " is not a map" : " map not found"));
+        return NULL;
+    }
+    if (sym.getType() != MAP) {
+        errorMsg(v + " is not a map");
+        return NULL;
+    }
+    bool success;
+    int handle = stack.peek(sym.getOffset(), success);
+    if (!success || handle < 0 || handle >= maps.size()) {
+        errorMsg("Could not access map " + v);
+        return NULL;
+    }
+    return &maps[handle];
+} // end map
+
+int ExecutionContext::getMapCount() {
+    return maps.size();
+}
+
+void ExecutionContext::freeMaps(int count) {
+    if (count < maps.size())
+        maps.resize(count);
+}
+
+int ExecutionContext::getArrayCount() {
+    return arrays.size();
+}
+
+void ExecutionContext::freeArrays(int count) {
+    if (count < arrays.size())
+        arrays.resize(count);
+}
+
+void ExecutionContext::poke(string v, int val,
+                   SymbolTable &localVars) // set variable to value and use localVars to find place on stack
+{
+    Symbol s = Symbol(v, 0, VARIABLE);
+    bool success = localVars.get(s); // update symbol table
+    if (!success) {
+        int *value = global(v);
+        if (value == NULL)
+            errorMsg("Invalid variable of " + v);
+        else
+            *value = val;
+        return;
+    }
+    if (s.getType() != VARIABLE) {
+        errorMsg(v + " is not a variable");
+        return;
+    }
+    // got the symbol for var, now get offset to stack
+    int offset = s.getOffset();
+    stack.poke(offset, val);
+}
+
+/** slot
+ input: v and localVars
+ output: return the address of variable v on the stack, or of GLOBAL v when no local is
+ called v. NULL (and an error) if v is neither. It stays good until the frame holding v
+ returns (for a GLOBAL, as long as the context)
+ */
+int *ExecutionContext::slot(string v, SymbolTable &localVars) {
+    Symbol sym = Symbol(v, 0, NONE);
+    if (!localVars.get(sym)) {
+        int *value = global(v);
+        if (value == NULL)
+            errorMsg(v + " variable not found");
+        return value;
+    }
+    if (sym.getType() != VARIABLE) {
+        errorMsg(v + " is not a variable");
+        return NULL;
+    }
+    int *value = stack.at(sym.getOffset());
+    if (value == NULL)
+        errorMsg("Could not access correct variable offset in stack");
+    return value;
+} // end slot
+
+/** global
+ input: v
+ output: return the address of GLOBAL v in this run's global area, NULL if there is none
+ */
+int *ExecutionContext::global(string v) {
+    Symbol sym = Symbol(v, 0, NONE);
+    if (!prog.getGlobal(sym) || sym.getOffset() >= globals.size())
+        return NULL;
+    return &globals[sym.getOffset()];
+} // end global
+
+void ExecutionContext::poke(int i, int val) // know which offset on stack you want to set
+{
+    if (!stack.poke(i, val))
+        errorMsg("Could not access correct index in stack");
+}
+
+
+void ExecutionContext::setLineNumber(int lineNum) // set the program line
+{
+    if (lineNum < 0 || lineNum >= prog.getSize())
+        errorMsg("New line number out of range");
+    else
+        lineNumber = lineNum;
+}
+
+/** trim
+ Trim the s string variable of beginning spaces and ending spaces or,
+ remove the beginning double quote and ending double quote (error if no quotes) or,
+ remove the ending parenthesis (error if no ending)
+ input: Trim t and s
+ Trim is a enum of SPACES, QUOTE, and PARENTHESIS
+ output: s is trimmed according to t
+ changed: s
+ */
+void ExecutionContext::trim(Trim t, string &s) {
+    int i;
+    if (t == SPACES) {
+        trimIt(s);
+    } else if (t == QUOTE) {
+        if (checkFirstChar(s, '"'))
+            chop(s, 1);
+        else
+            errorMsg("No beginning quote");
+        i = s.length() - 1;
+        if (i >= 0 && s[i] == '"')
+            s = s.substr(0, i);
+        else
+            errorMsg("No ending quote");
+    } else if (t == PARENTHESIS) {
+        if (checkFirstChar(s, '('))
+            chop(s, 1);
+        else
+            errorMsg("No beginning parenthesis");
+        i = s.length() - 1;
+        if (i >= 0 && s[i] == ')')
+            s = s.substr(0, i);
+        else
+            errorMsg("No ending parenthesis");
+    } else
+        errorMsg("Bad trim value");
+
+} // end trim
+
+/** trimIt
+ input: s
+ output: remove all leading and trailing spaces from s
+ changed: s
+ */
+void ExecutionContext::trimIt(string &s) {
+    int i;
+    while (checkFirstChar(s, ' ')) {
+        chop(s, 1);
+    }
+    i = s.length() - 1;
+    while (s.length() > 0 && s[i] == ' ') {
+        s = s.substr(0, i);
+        i--;
+    }
+} // end trimIt
@@ -0,0 +1,232 @@
+//
+//  ExecutionContext.h
+//  MinusMinusV3
+//
+//  Created by Tony Biehl on 2/10/21.
+//  Copyright © 2021 Tony Biehl. All rights reserved.
+//
+/*
+--------------------------------------------------
+                  ExecutionContext
+--------------------------------------------------
+ -prog:CompiledProgram (shared, read only)
+ -stack:Stack<int>
+ -lastToken:string
+ -command:Command
+ -lineNumber:integer
+ -line:string
+ -errorCount:integer
+ -statementCount:long
+ -stats:RunStats
+ -arrays:vector of integer buffers
+ -maps:vector of IntMap
+ -globals:vector of integer
+ -in:istream, out:ostream, err:ostream
+ -random:minstd_rand
+ -quantum:integer, sliceLeft:integer, yieldHook:function
+ -maxStatements:long, deadline:time, ticksLeft:integer, limitExceeded:bool
+ -lineProfiler:LineProfiler, callProfiler:CallProfiler, sampler:SamplingProfiler, tracer:Tracer
+--------------------------------------------------
+ +operator=(lineNum:integer):void // goto lineNum
+ +operator++():string // next line and return the command
+ +operator-=(e:Extract):string // get next token
+ +operator*=(c:Commands, p:ExecutionContext):Commands // friend operator to get the command
+ +operator*=(s:string, p:ExecutionContext):string // friend operator to get the last token
+ +operator*=(line:integer, p:ExecutionContext):integer // friend operator to get the last item on stack
+ +peek():integer // get a copy of top of stack
+ +peek(v:string, localVars:SymbolTable):integer // get a copy of the value of local variable (localVars points to correct place)
+ +pop():integer // pop last line from stack
+ +push(line:integer):void // push current line onto stack
+ +push(v:string, localVars:SymbolTable):void // push local variable space onto stack and add variable to localVars
+ +setVar(v:string, val:integer, localVars:SymbolTable):void // set variable to value and use localVars to find place on stack
+ +pushArray(v:string, size:integer, localVars:SymbolTable):bool // declare array v of size elements
+ +element(v:string, index:integer, localVars:SymbolTable):integer pointer // element of array v, NULL if out of bounds
+ +array(v:string, localVars:SymbolTable):vector pointer // buffer of array v, NULL if not an array
+ +pushMap(v:string, localVars:SymbolTable):bool // declare map v
+ +map(v:string, localVars:SymbolTable):IntMap pointer // map v, NULL if not a map
+ +slot(v:string, localVars:SymbolTable):integer pointer // where variable v is (local, else GLOBAL), NULL if none
+ +global(v:string):integer pointer // slot of GLOBAL v, NULL if there is none
+--------------------------------------------------
+ One run of a CompiledProgram. Everything that changes while a program runs
+ lives here, so a context is cheap to create and any number of them can run
+ the same CompiledProgram independently. That includes the program's input,
+ output, error messages and rand() sequence: nothing is shared with other
+ contexts, so contexts on different threads need no locking.
+ */
+#ifndef ExecutionContext_h
+#define ExecutionContext_h
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cctype>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "CallProfiler.h"
+#include "CompiledProgram.h"
+#include "IntMap.h"
+#include "LineProfiler.h"
+#include "RunStats.h"
+#include "SamplingProfiler.h"
+#include "SymbolTable.h"
+#include "Stack.h"
+#include "Tracer.h"
+
+using namespace std;
+
+enum Extract {
+    BOOLEAN, CMD, COMMA, COMPARE, EQUATION, LINE, PARMS, OPEN_PARM, STRING, TOKEN
+};
+enum Trim {
+    SPACES, QUOTE, PARENTHESIS, NO_TRIM
+};
+
+const char FUNCTION_ARG = '~';
+// nextToken end characters
+const char END_COMMA = ',';
+const char END_LINE = '~';
+const char END_COMPARE = '=';
+const char END_PAREN = '(';
+const char END_SPACE = ' ';
+const char END_CMD = '^';
+
+const int LIMIT_CLOCK_TICKS = 256; // backward jumps and calls between reads of the clock
+const int ARRAY_MAX = 1000000; // most elements one DECLAREd array may have
+
+bool checkFirstChar(string s, char ch);
+
+bool splitIndex(string s, string &name, string &index);
+
+bool splitKey(string s, string &name, string &key);
+
+void chop(string &str, int x);
+
+class ExecutionContext {
+private:
+    const CompiledProgram &prog; // the program being run
+    Stack<int> stack;
+    string lastToken;
+    Commands command;
+    int lineNumber;
+    string line;
+    int errorCount;
+    long statementCount; // lines dispatched by operator++
+    RunStats stats; // work done by this run
+    vector<vector<int>> arrays; // DECLAREd arrays, the stack slot of an array holds its index here
+    vector<IntMap> maps; // DECLAREd maps, the stack slot of a map holds its index here
+    vector<int> globals; // the GLOBAL variables, slots given out by the CompiledProgram
+    istream *in; // INPUT reads from here
+    ostream *out; // PRINT and PRINTLN write here
+    ostream *err; // errorMsg writes here
+    minstd_rand random; // for the built-in rand()
+    int quantum; // lines per slice before calling yieldHook, 0 to run to the end
+    int sliceLeft; // lines left in this slice
+    void (*yieldHook)(void *); // gives the thread back to whoever is running this context
+    void *yieldArg; // passed to yieldHook
+    bool limited; // a statement limit or deadline is set
+    long maxStatements; // most lines the run may dispatch, 0 for no limit
+    chrono::steady_clock::time_point deadline;
+    bool hasDeadline;
+    int ticksLeft; // ticks until the clock is read again
+    bool limitExceeded; // the run was stopped by a limit
+    LineProfiler *lineProfiler; // NULL when not profiling
+    CallProfiler *callProfiler; // NULL when not profiling
+    SamplingProfiler *sampler; // shadow of the line and calls for SIGPROF, NULL when not sampling
+    Tracer *tracer; // NULL when not tracing
+
+public:
+    ExecutionContext(const CompiledProgram &program, unsigned int seed = 1);
+
+    bool addParmOffset(string parm, int offset,
+                       SymbolTable &localVars); // add the parameter to the local vars and attach the offset to the stack to it
+
+    Commands convertLine(string &c); // convert the c string into Commands and chop off the command from c
+
+    //Get SymbolTable of localVars and parameters passed via s (in parenthesis), Take every argument in s and either push a zero onto the stack or push the parsed value
+    int countArguments(SymbolTable &localVars, string &s);
+    bool errorMsg(string msg); // Print the msg as an error with the line number, Increment errorCount
+    int getLineNumber(); // returns the current line number being interpreted
+    int getErrorCount(); // returns current errrorCount
+    string getLine(); // returns what is left of the current line
+    void setLine(string rest); // put back what is left of the current line (after a call)
+    const CompiledProgram &getProgram(); // returns the program being run
+    bool getMethod(Symbol &); // looks for method named in Symbol s and, if found, fills in offset and type in s
+    int getStackSize(); // returns the number of items on the stack
+    long getStatementCount(); // returns how many lines have been dispatched
+    RunStats &getStats(); // returns the work counted so far, callers add to the counts they own
+    CallProfiler *getCallProfiler(); // returns the call profiler, NULL when not profiling
+    void setCallProfiler(CallProfiler *profiler); // time every call into profiler, NULL to stop
+    LineProfiler *getLineProfiler(); // returns the line profiler, NULL when not profiling
+    void setLineProfiler(LineProfiler *profiler); // time every line into profiler, NULL to stop
+    SamplingProfiler *getSampler(); // returns the sampling profiler, NULL when not sampling
+    void setSampler(SamplingProfiler *profiler); // keep profiler's shadow up to date, NULL to stop
+    Tracer *getTracer(); // returns the tracer, NULL when not tracing
+    void setTracer(Tracer *t); // record calls, INPUT waits and flushes into t, NULL to stop
+    bool isLimitExceeded(); // returns true if the run was stopped by setLimits
+    istream &getIn(); // where INPUT reads from
+    ostream &getOut(); // where PRINT and PRINTLN write to
+    int nextRandom(); // next value of this context's rand()
+    void seed(unsigned int s); // restart this context's rand() sequence from s
+    void setErrorStream(ostream &e); // send error messages to e (cout by default)
+    void setIO(istream &i, ostream &o); // read INPUT from i and PRINT to o (cin and cout by default)
+    void setQuantum(int lines, void (*hook)(void *), void *arg); // call hook(arg) every lines lines, 0 to stop
+    void setLimits(long statements, long deadlineMs); // stop the run after statements lines or deadlineMs, 0 for no limit
+    bool tick(); // check the limits at a backward jump or call, false (with an error) once one is passed
+    bool isOperator(string s); // returns true or false if string s is ‘+’, ‘-’, ‘/’, ‘*’ or ‘%’
+    bool isValidID(string id); // returns true or false if string id is a valid MinusMinus id
+    void operator=(int lineNum); // goto lineNum
+    Commands operator++(); // next line and return the command
+    string operator-=(Extract e); // get next token
+    bool operator==(string method); // see if valid function or procedure
+    friend Commands &operator*=(Commands &c, ExecutionContext &p); // friend operator to get the command
+    friend string &operator*=(string &s, ExecutionContext &p); // friend operator to get the last token
+    friend int &operator*=(int &offset, ExecutionContext &p); // friend operator to get the item on stack via offset
+
+    /**
+     * String s has equation to get the next part (factor) of
+Gets and returns next factor of an equation: operator, literal, variable or function
+With function call, FUNCTION_ARG (~) is appended to the front (for parseEquation) for easier recognition
+s is changed (factor is removed) */
+    string nextFactor(string &s);
+
+    string nextToken(string &s, char endCH);
+
+    int peek(); // get a copy of top of stack
+    int peek(string v,
+             SymbolTable &localVars); // get a copy of the value of local variable (localVars points to correct place on stack)
+    int peek(int i); // know which offset on stack you want
+    void poke(string v, int val, SymbolTable &localVars); // set variable to value and use localVars to find place on stack
+    void poke(int i, int val); // know which offset on stack you want to set
+    int *slot(string v, SymbolTable &localVars); // address of local (else GLOBAL) v, NULL (and an error) if not a variable
+    int *global(string v); // address of GLOBAL v, NULL if there is no such GLOBAL
+    void pop(int x); // pop last x items from stack
+    int precedence(string s); // returns 1 is s is a ‘*’,’/’, or ‘%’, else 0
+
+    void push(int line); // push current line onto stack
+    bool push(string v, SymbolTable &localVars); // push local variable space onto stack and add variable to localVars
+    bool pushArray(string v, int size, SymbolTable &localVars); // declare array v of size zeros, its index goes on the stack
+    int *element(string v, int index, SymbolTable &localVars); // element index of array v, NULL (and an error) if out of bounds
+    vector<int> *array(string v, SymbolTable &localVars); // the buffer of array v, NULL (and an error) if v is not an array
+    int getArrayCount(); // arrays declared and not yet freed
+    void freeArrays(int count); // free the arrays declared after the first count, as a frame returns
+    bool pushMap(string v, SymbolTable &localVars); // declare map v, its index goes on the stack
+    IntMap *map(string v, SymbolTable &localVars); // map v, NULL (and an error) if v is not a map
+    int getMapCount(); // maps declared and not yet freed
+    void freeMaps(int count); // free the maps declared after the first count, as a frame returns
+
+    void setLineNumber(int lineNum); // set the program line number to lineNum (i.e. go to a particular part of the MinusMinus program)
+
+
+    /**
+     * SPACE, remove from s beginning spaces and ending spaces
+    QUOTE, remove from s beginning double quote and ending double quote (error if no quotes)
+    PARENTHESIS, remove from s the ending parenthesis (error if no ending)*/
+    void trim(Trim t, string &s);
+
+    void trimIt(string &s); // remove all leading and trailing spaces from s
+
+};
+
+#endif /* ExecutionContext_h */
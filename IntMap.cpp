@@ -0,0 +1,119 @@
+//
+//  IntMap.cpp
+//  MinusMinusV3
+//
+
+#include "IntMap.h"
+
+const int MAP_FIRST_SLOTS = 8; // table size when the first key is added
+
+IntMap::IntMap() {
+    shift = 32;
+}
+
+/** home
+ input: key
+ output: the slot key hashes to (Fibonacci hashing, the top bits of key times 2^32 / phi)
+ */
+int IntMap::home(int key) const {
+    return (int) (((unsigned int) key * 2654435769u) >> shift);
+} // end home
+
+/** find
+ input: key (the table must have room)
+ output: return the slot holding key's entry number, or the empty slot where it would go
+ */
+int IntMap::find(int key) const {
+    int mask = slots.size() - 1;
+    int slot = home(key);
+    while (slots[slot] >= 0 && entries[slots[slot]].key != key)
+        slot = (slot + 1) & mask;
+    return slot;
+} // end find
+
+/** grow
+ output: double the table (or make the first one) and put every entry back in it
+ changed: slots and shift
+ */
+void IntMap::grow() {
+    int newSize = slots.empty() ? MAP_FIRST_SLOTS : slots.size() * 2;
+    slots.assign(newSize, -1);
+    shift = 32;
+    for (int bits = newSize; bits > 1; bits >>= 1)
+        shift--;
+    for (int i = 0; i < entries.size(); i++)
+        slots[find(entries[i].key)] = i;
+} // end grow
+
+int IntMap::size() const {
+    return entries.size();
+}
+
+bool IntMap::has(int key) const {
+    return !slots.empty() && slots[find(key)] >= 0;
+}
+
+int IntMap::get(int key) const {
+    if (slots.empty())
+        return 0;
+    int entry = slots[find(key)];
+    return entry >= 0 ? entries[entry].value : 0;
+}
+
+/** at
+ input: key
+ output: return the value of key to read or change, adding key with 0 if it is missing.
+ The table is kept at most half full
+ changed: entries and slots
+ */
+int &IntMap::at(int key) {
+    if (slots.empty())
+        grow();
+    int slot = find(key);
+    if (slots[slot] < 0) {
+        if ((entries.size() + 1) * 2 > slots.size()) {
+            grow();
+            slot = find(key);
+        }
+        slots[slot] = entries.size();
+        Entry entry = {key, 0};
+        entries.push_back(entry);
+    }
+    return entries[slots[slot]].value;
+} // end at
+
+/** remove
+ input: key
+ output: take key out and return true, false if it was not there. Entries after the hole in
+ the same probe run are shifted back (no tombstones), and the last entry moves into the
+ hole in entries so they stay packed
+ changed: entries and slots
+ */
+bool IntMap::remove(int key) {
+    if (slots.empty())
+        return false;
+    int mask = slots.size() - 1;
+    int hole = find(key);
+    int entry = slots[hole];
+    if (entry < 0)
+        return false;
+    for (int slot = (hole + 1) & mask; slots[slot] >= 0; slot = (slot + 1) & mask) {
+        int start = home(entries[slots[slot]].key);
+        if (((slot - start) & mask) >= ((slot - hole) & mask)) { // its probe run passes the hole
+            slots[hole] = slots[slot];
+            hole = slot;
+        }
+    }
+    slots[hole] = -1;
+    int last = entries.size() - 1;
+    if (entry != last) {
+        entries[entry] = entries[last];
+        slots[find(entries[entry].key)] = entry;
+    }
+    entries.pop_back();
+    return true;
+} // end remove
+
+int IntMap::keyAt(int i) const {
+    return entries[i].key;
+}
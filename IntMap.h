@@ -0,0 +1,58 @@
+//
+//  IntMap.h
+//  MinusMinusV3
+//
+/*
+ The integer to integer hash table behind DECLARE m MAP. Entries are kept
+ packed in one vector (key and value side by side, in insertion order until
+ a remove moves the last entry into the hole), so walking a map with key(m, i)
+ is a plain array walk. Lookups go through an open addressing table of entry
+ numbers with linear probing, which stays at most half full, so a lookup is a
+ multiply, a shift and usually one or two probes of adjacent ints.
+
+ An empty map allocates nothing; the table doubles as entries are added.
+ */
+#ifndef IntMap_h
+#define IntMap_h
+
+#include <vector>
+
+using namespace std;
+
+class IntMap {
+private:
+    struct Entry {
+        int key;
+        int value;
+    };
+    vector<Entry> entries; // packed, entries[i] is the i-th key of key(m, i)
+    vector<int> slots; // open addressing table of entry numbers, -1 for empty, size a power of 2
+    int shift; // 32 - log2 of the table size, for the multiplicative hash
+
+    int home(int key) const; // first slot to probe for key
+    int find(int key) const; // slot holding key, or the empty slot where it would go
+    void grow(); // double the table and put every entry back
+
+public:
+    IntMap();
+
+    // number of keys
+    int size() const;
+
+    // true if key is in the map
+    bool has(int key) const;
+
+    // value of key, 0 if it is not in the map
+    int get(int key) const;
+
+    // value of key to change, added with 0 if missing. Good until the next key is added
+    int &at(int key);
+
+    // take key out of the map, false if it was not there
+    bool remove(int key);
+
+    // key number i, 0 <= i < size()
+    int keyAt(int i) const;
+};
+
+#endif /* IntMap_h */
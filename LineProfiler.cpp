@@ -0,0 +1,75 @@
+//
+//  LineProfiler.cpp
+//  MinusMinusV3
+//
+
+#include "LineProfiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+LineProfiler::LineProfiler() {
+    for (int i = 0; i < SIZE; i++) {
+        count[i] = 0;
+        totalNs[i] = selfNs[i] = 0;
+    }
+    childNs = 0;
+}
+
+long LineProfiler::getCount(int line) {
+    return count[line];
+}
+
+long long LineProfiler::getSelfNs(int line) {
+    return selfNs[line];
+}
+
+/** report
+ input: prog (the program profiled) and out
+ output: print one row per line that ran: line number, count, self and total
+ milliseconds, share of all self time and the source text, most self time first
+ */
+void LineProfiler::report(const CompiledProgram &prog, ostream &out) {
+    vector<int> lines;
+    long long allNs = 0;
+    for (int i = 0; i < prog.getSize(); i++) {
+        if (count[i] > 0) {
+            lines.push_back(i);
+            allNs += selfNs[i];
+        }
+    }
+    sort(lines.begin(), lines.end(), [this](int a, int b) { return selfNs[a] > selfNs[b]; });
+    out << "line       count     self ms    total ms   self%  source" << endl;
+    for (int i = 0; i < lines.size(); i++) {
+        int l = lines[i];
+        out << setw(4) << l + 1 << setw(12) << count[l]
+            << fixed << setprecision(3) << setw(12) << selfNs[l] / 1e6 << setw(12) << totalNs[l] / 1e6
+            << setprecision(1) << setw(8) << (allNs > 0 ? 100.0 * selfNs[l] / allNs : 0.0)
+            << "  " << prog.getLine(l) << endl;
+    }
+} // end report
+
+LineTimer::LineTimer(LineProfiler *profiler, int line) {
+    this->profiler = profiler;
+    if (profiler == NULL)
+        return;
+    this->line = line;
+    savedChildNs = profiler->childNs;
+    profiler->childNs = 0;
+    start = chrono::steady_clock::now();
+}
+
+/** ~LineTimer
+ output: add the time since construction to the line's total, and that time less
+ the time of lines timed inside it to its self time
+ changed: profiler
+ */
+LineTimer::~LineTimer() {
+    if (profiler == NULL || line < 0 || line >= SIZE)
+        return;
+    long long ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    profiler->count[line]++;
+    profiler->totalNs[line] += ns;
+    profiler->selfNs[line] += ns - profiler->childNs;
+    profiler->childNs = savedChildNs + ns; // this line is a child of the one it runs inside
+} // end ~LineTimer
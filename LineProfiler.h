@@ -0,0 +1,58 @@
+//
+//  LineProfiler.h
+//  MinusMinusV3
+//
+/*
+ Counts how often each program line runs and how long it takes. execute()
+ puts a LineTimer around every line it dispatches; with no LineProfiler set
+ on the ExecutionContext the timer does nothing but test a null pointer.
+
+ Total time of a line includes the lines of any function it calls, self time
+ does not. The report is sorted by self time.
+ */
+#ifndef LineProfiler_h
+#define LineProfiler_h
+
+#include <chrono>
+#include <iostream>
+#include "CompiledProgram.h"
+
+using namespace std;
+
+class LineProfiler {
+private:
+    long count[SIZE]; // times each line ran
+    long long totalNs[SIZE]; // time in each line, calls included
+    long long selfNs[SIZE]; // time in each line, calls left out
+    long long childNs; // time of lines timed inside the line being timed
+
+    friend class LineTimer;
+
+public:
+    LineProfiler();
+
+    // return how many times line ran
+    long getCount(int line);
+
+    // return nanoseconds spent in line, without the lines it called
+    long long getSelfNs(int line);
+
+    // print every line that ran, most self time first, with its source text from prog
+    void report(const CompiledProgram &prog, ostream &out);
+};
+
+// times one line for a LineProfiler, from construction to destruction
+class LineTimer {
+private:
+    LineProfiler *profiler; // NULL when not profiling
+    int line;
+    long long savedChildNs; // childNs of the line this one runs inside
+    chrono::steady_clock::time_point start;
+
+public:
+    LineTimer(LineProfiler *profiler, int line);
+
+    ~LineTimer();
+};
+
+#endif /* LineProfiler_h */
@@ -0,0 +1,48 @@
+//
+//  RunStats.cpp
+//  MinusMinusV3
+//
+
+#include "RunStats.h"
+#include <iomanip>
+
+thread_local RunStats *currentStats = NULL;
+
+RunStats::RunStats() {
+    lines = tokens = factors = equations = operations = lookups = probes = pushes = calls = allocations = 0;
+    stackHighWater = callDepth = maxCallDepth = 0;
+    bytesAllocated = 0;
+}
+
+/** printStats
+ input: stats, out and json
+ output: print stats to out as a two column table, or as one JSON object when json is true
+ */
+void printStats(const RunStats &stats, ostream &out, bool json) {
+    const char *names[] = {"lines", "tokens", "factors", "equations", "operations", "lookups", "probes", "pushes",
+                           "stack_high_water", "calls", "max_call_depth", "allocations", "bytes_allocated"};
+    long long values[] = {stats.lines, stats.tokens, stats.factors, stats.equations, stats.operations, stats.lookups,
+                          stats.probes, stats.pushes, stats.stackHighWater, stats.calls, stats.maxCallDepth,
+                          stats.allocations, stats.bytesAllocated};
+    int count = sizeof(values) / sizeof(values[0]);
+    if (json) {
+        out << "{";
+        for (int i = 0; i < count; i++)
+            out << (i > 0 ? ", " : "") << "\"" << names[i] << "\": " << values[i];
+        out << "}" << endl;
+        return;
+    }
+    for (int i = 0; i < count; i++)
+        out << left << setw(18) << names[i] << right << setw(14) << values[i] << endl;
+} // end printStats
+
+/** printCounts
+ input: stats and out
+ output: print the deterministic work counts (statements, operations, calls, lookups and
+ allocations) as one JSON object, without a newline
+ */
+void printCounts(const RunStats &stats, ostream &out) {
+    out << "{\"statements\": " << stats.lines << ", \"operations\": " << stats.operations
+        << ", \"calls\": " << stats.calls << ", \"lookups\": " << stats.lookups
+        << ", \"allocations\": " << stats.allocations << "}";
+} // end printCounts
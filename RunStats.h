@@ -0,0 +1,60 @@
+//
+//  RunStats.h
+//  MinusMinusV3
+//
+/*
+ Counts of the work one ExecutionContext did, for capacity planning and for
+ checking that a change to the engine really does less work. The context
+ counts what goes through it (lines, tokens, factors, stack pushes), run()
+ and callMethod count equations and calls, and SymbolTable::get and the
+ global operator new count into currentStats, the RunStats of the run on
+ this thread. run() sets currentStats and a context that yields to the
+ Scheduler clears it while another run has the thread.
+
+ None of the counts depend on timing, so two runs of the same program with
+ the same input (and rand seed) count exactly the same work. printCounts
+ prints the ones that make a noise free performance signal.
+ */
+#ifndef RunStats_h
+#define RunStats_h
+
+#include <iostream>
+
+using namespace std;
+
+struct RunStats {
+    long lines; // lines dispatched
+    long tokens; // nextToken calls
+    long factors; // nextFactor calls
+    long equations; // parseEquation calls
+    long operations; // arithmetic operators and comparisons evaluated
+    long lookups; // SymbolTable::get calls
+    long probes; // symbols compared by those lookups
+    long pushes; // values pushed on the run's stack
+    int stackHighWater; // most values on the stack at once
+    long calls; // user FUNCTION and PROCEDURE calls
+    int callDepth; // calls open right now
+    int maxCallDepth;
+    long allocations; // operator new calls
+    long long bytesAllocated;
+
+    RunStats();
+};
+
+// RunStats of the run on this thread, NULL when nothing is counted
+extern thread_local RunStats *currentStats;
+
+/** printStats
+ input: stats, out and json
+ output: print stats to out as a two column table, or as one JSON object when json is true
+ */
+void printStats(const RunStats &stats, ostream &out, bool json = false);
+
+/** printCounts
+ input: stats and out
+ output: print the deterministic work counts (statements, operations, calls, lookups and
+ allocations) as one JSON object, without a newline
+ */
+void printCounts(const RunStats &stats, ostream &out);
+
+#endif /* RunStats_h */
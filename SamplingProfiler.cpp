@@ -0,0 +1,160 @@
+//
+//  SamplingProfiler.cpp
+//  MinusMinusV3
+//
+
+#include "SamplingProfiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <sys/time.h>
+
+static SamplingProfiler *volatile active = NULL; // the profiler SIGPROF samples into
+
+SamplingProfiler::SamplingProfiler() : lines(SAMPLE_CAPACITY), depths(SAMPLE_CAPACITY),
+                                       frames((size_t) SAMPLE_CAPACITY * SAMPLE_FRAMES) {
+    shadow.line = -1;
+    shadow.depth = 0;
+    taken = dropped = 0;
+    running = false;
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+/** handler
+ input: the signal (SIGPROF, not used)
+ output: copy the shadow of the active profiler into its next sample, keeping the innermost
+ SAMPLE_FRAMES methods of a deeper stack. Async signal safe: only reads and writes memory
+ allocated before the timer started
+ */
+void SamplingProfiler::handler(int) {
+    SamplingProfiler *p = active;
+    if (p == NULL)
+        return;
+    int n = p->taken;
+    if (n >= SAMPLE_CAPACITY) {
+        p->dropped = p->dropped + 1;
+        return;
+    }
+    int depth = p->shadow.depth;
+    if (depth > SHADOW_FRAMES)
+        depth = SHADOW_FRAMES;
+    int first = depth > SAMPLE_FRAMES ? depth - SAMPLE_FRAMES : 0; // outermost frame kept
+    p->lines[n] = p->shadow.line;
+    p->depths[n] = depth;
+    int *frame = &p->frames[(size_t) n * SAMPLE_FRAMES];
+    for (int i = first; i < depth; i++)
+        frame[i - first] = p->shadow.frames[i];
+    p->taken = n + 1;
+} // end handler
+
+/** start
+ input: intervalUs
+ output: install the SIGPROF handler and start the CPU timer. Return false if another
+ profiler is sampling or the timer could not be set
+ changed: active, oldAction and running
+ */
+bool SamplingProfiler::start(int intervalUs) {
+    if (running || active != NULL)
+        return false;
+    if (intervalUs <= 0)
+        intervalUs = SAMPLE_INTERVAL_US;
+    struct sigaction action;
+    action.sa_handler = handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART; // INPUT reads carry on after a sample
+    active = this;
+    if (sigaction(SIGPROF, &action, &oldAction) != 0) {
+        active = NULL;
+        return false;
+    }
+    struct itimerval timer;
+    timer.it_interval.tv_sec = intervalUs / 1000000;
+    timer.it_interval.tv_usec = intervalUs % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        sigaction(SIGPROF, &oldAction, NULL);
+        active = NULL;
+        return false;
+    }
+    running = true;
+    return true;
+} // end start
+
+/** stop
+ output: stop the timer and put back the old SIGPROF handler
+ changed: active and running
+ */
+void SamplingProfiler::stop() {
+    if (!running)
+        return;
+    struct itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, NULL);
+    sigaction(SIGPROF, &oldAction, NULL);
+    active = NULL;
+    running = false;
+} // end stop
+
+int SamplingProfiler::getSampleCount() {
+    return taken;
+}
+
+/** report
+ input: prog and out
+ output: print every line that was sampled, most samples first, with its share of the samples
+ */
+void SamplingProfiler::report(const CompiledProgram &prog, ostream &out) {
+    vector<long> count(SIZE, 0);
+    int n = taken;
+    for (int i = 0; i < n; i++)
+        if (lines[i] >= 0 && lines[i] < SIZE)
+            count[lines[i]]++;
+    vector<int> order;
+    for (int i = 0; i < SIZE; i++)
+        if (count[i] > 0)
+            order.push_back(i);
+    sort(order.begin(), order.end(), [&count](int a, int b) {
+        return count[a] > count[b];
+    });
+    out << n << " samples";
+    if (dropped > 0)
+        out << ", " << dropped << " dropped (buffer full)";
+    out << endl << "line  samples      %  source" << endl;
+    for (int i = 0; i < order.size(); i++) {
+        int line = order[i];
+        out << setw(4) << line + 1 << setw(9) << count[line] << fixed << setprecision(1)
+            << setw(7) << 100.0 * count[line] / n << "  " << prog.getLine(line) << endl;
+    }
+} // end report
+
+/** writeFolded
+ input: prog and out
+ output: print "main;f;g;g:12 count" for every call stack sampled, the line is 1 based.
+ A stack that was cut to its innermost SAMPLE_FRAMES methods starts "main;...;"
+ */
+void SamplingProfiler::writeFolded(const CompiledProgram &prog, ostream &out) {
+    map<string, long> stacks;
+    int n = taken;
+    for (int i = 0; i < n; i++) {
+        ostringstream key;
+        string leaf = "main";
+        key << "main";
+        const int *frame = &frames[(size_t) i * SAMPLE_FRAMES];
+        int kept = depths[i];
+        if (kept > SAMPLE_FRAMES) {
+            kept = SAMPLE_FRAMES;
+            key << ";...";
+        }
+        for (int j = 0; j < kept; j++) {
+            leaf = prog.getMethodName(frame[j]);
+            key << ";" << leaf;
+        }
+        key << ";" << leaf << ":" << lines[i] + 1;
+        stacks[key.str()]++;
+    }
+    for (map<string, long>::iterator it = stacks.begin(); it != stacks.end(); it++)
+        out << it->first << " " << it->second << endl;
+} // end writeFolded
@@ -0,0 +1,91 @@
+//
+//  SamplingProfiler.h
+//  MinusMinusV3
+//
+/*
+ Statistical profiler for runs where timing every line would change what is
+ being measured. setitimer(ITIMER_PROF) raises SIGPROF every interval of CPU
+ time and the handler copies the shadow (line being run and the methods open)
+ into a buffer allocated by start, so the handler never allocates or locks.
+
+ The interpreter keeps the shadow up to date through atLine, enter and leave,
+ which are only stores to sig_atomic_t fields. Only one SamplingProfiler can
+ be started at a time, SIGPROF goes to the process.
+ */
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#include <csignal>
+#include <iostream>
+#include <vector>
+#include "CompiledProgram.h"
+#include "Stack.h"
+
+using namespace std;
+
+const int SAMPLE_FRAMES = 64; // frames a sample keeps, the innermost ones of a deeper call stack
+const int SHADOW_FRAMES = STACK_SIZE; // every call pushes its return line, so no run goes deeper
+const int SAMPLE_CAPACITY = 1 << 16; // samples kept, about a minute of CPU at the default rate
+const int SAMPLE_INTERVAL_US = 1000; // default microseconds of CPU time between samples
+
+// what the run is doing right now, read by the signal handler
+struct SampleShadow {
+    volatile sig_atomic_t line; // program line being run
+    volatile sig_atomic_t depth; // methods open, main program not counted
+    volatile sig_atomic_t frames[SHADOW_FRAMES]; // heading line of each method open, outermost first
+};
+
+class SamplingProfiler {
+private:
+    SampleShadow shadow;
+    vector<int> lines; // line of each sample
+    vector<int> depths; // methods open at each sample, more than SAMPLE_FRAMES when it was cut
+    vector<int> frames; // SAMPLE_FRAMES heading lines per sample, the innermost methods open
+    volatile sig_atomic_t taken; // samples in the buffer
+    volatile sig_atomic_t dropped; // samples lost because the buffer was full
+    struct sigaction oldAction; // SIGPROF handler before start
+    bool running;
+
+    static void handler(int signal);
+
+public:
+    SamplingProfiler();
+
+    ~SamplingProfiler();
+
+    // start sampling every intervalUs microseconds of CPU time, false if the timer could not be set
+    bool start(int intervalUs = SAMPLE_INTERVAL_US);
+
+    // stop sampling, the samples are kept
+    void stop();
+
+    // the run moved to line
+    void atLine(int line) {
+        shadow.line = line;
+    }
+
+    // the run called the method with its heading on line
+    void enter(int line) {
+        if (shadow.depth < SHADOW_FRAMES)
+            shadow.frames[shadow.depth] = line; // before depth, so a sample never sees an unset frame
+        shadow.depth = shadow.depth + 1;
+    }
+
+    // the innermost method returned
+    void leave() {
+        if (shadow.depth > 0)
+            shadow.depth = shadow.depth - 1;
+    }
+
+    // return how many samples were taken
+    int getSampleCount();
+
+    // print samples per line, most first, with its source text from prog
+    void report(const CompiledProgram &prog, ostream &out);
+
+    // print one line per call stack seen, "main;f;g;g:12 count", the last frame is method:line.
+    // A stack deeper than SAMPLE_FRAMES is "main;...;" and its innermost methods
+    void writeFolded(const CompiledProgram &prog, ostream &out);
+};
+
+#endif /* SamplingProfiler_h */
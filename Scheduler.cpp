@@ -0,0 +1,149 @@
+//
+//  Scheduler.cpp
+//  MinusMinusV3
+//
+
+#include "Scheduler.h"
+#include <chrono>
+#include <queue>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include "support.hpp"
+
+Scheduler::Scheduler(int threads, int quantum) {
+    if (threads <= 0)
+        threads = thread::hardware_concurrency();
+    this->threads = threads > 0 ? threads : 1;
+    this->quantum = quantum > 0 ? quantum : 1;
+}
+
+Scheduler::~Scheduler() {
+    for (int i = 0; i < tasks.size(); i++) {
+        if (tasks[i]->stack != NULL)
+            munmap(tasks[i]->stack, FIBER_STACK_SIZE + getpagesize());
+        delete tasks[i];
+    }
+}
+
+/** add
+ input: context and priority
+ output: make context a task that yields every quantum lines and return its number
+ changed: tasks and context
+ */
+int Scheduler::add(ExecutionContext &context, int priority) {
+    Task *t = new Task;
+    t->context = &context;
+    t->priority = priority;
+    t->turn = 0;
+    t->back = NULL;
+    t->stack = NULL;
+    t->started = t->finished = false;
+    t->errors = 0;
+    t->wallMs = 0;
+    context.setQuantum(quantum, yieldTask, t);
+    tasks.push_back(t);
+    return tasks.size() - 1;
+} // end add
+
+/** runAll
+ input: none
+ output: deal the tasks out to the worker threads and return when all of them are done
+ */
+void Scheduler::runAll() {
+    int count = threads < (int) tasks.size() ? threads : tasks.size();
+    vector<thread> workers;
+    for (int i = 0; i < count; i++)
+        workers.push_back(thread(&Scheduler::work, this, i));
+    for (int i = 0; i < workers.size(); i++)
+        workers[i].join();
+} // end runAll
+
+int Scheduler::getErrors(int task) {
+    return tasks[task]->errors;
+}
+
+double Scheduler::getWallMs(int task) {
+    return tasks[task]->wallMs;
+}
+
+/** taskMain
+ input: high and low halves of the Task pointer (makecontext only passes ints)
+ output: run the task's program to the end, then go back to the worker for good
+ */
+void Scheduler::taskMain(unsigned int high, unsigned int low) {
+    Task *t = (Task *) (((uintptr_t) high << 16 << 16) | low);
+    t->errors = run(*t->context);
+    t->finished = true;
+    setcontext(t->back);
+} // end taskMain
+
+/** yieldTask
+ input: the Task running (given to ExecutionContext::setQuantum)
+ output: save where the task is and switch back to its worker
+ */
+void Scheduler::yieldTask(void *task) {
+    Task *t = (Task *) task;
+    swapcontext(&t->fiber, t->back);
+} // end yieldTask
+
+/** work
+ input: worker number
+ output: run every task dealt to this worker (task number % threads == worker), one
+ quantum at a time, until all have finished. Highest priority goes first, then the
+ task that has waited longest
+ */
+void Scheduler::work(int worker) {
+    struct Later {
+        bool operator()(Task *a, Task *b) {
+            if (a->priority != b->priority)
+                return a->priority < b->priority;
+            return a->turn > b->turn;
+        }
+    };
+    priority_queue<Task *, vector<Task *>, Later> ready;
+    ucontext_t home; // this worker, tasks switch back here
+    long turn = 0;
+    int page = getpagesize();
+    for (int i = worker; i < tasks.size(); i += threads) {
+        tasks[i]->turn = turn++;
+        ready.push(tasks[i]);
+    }
+    while (!ready.empty()) {
+        Task *t = ready.top();
+        ready.pop();
+        if (!t->started) { // give it a stack, with a guard page so an overflow faults
+            t->stack = (char *) mmap(NULL, FIBER_STACK_SIZE + page, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (t->stack == MAP_FAILED) {
+                t->stack = NULL;
+                t->context->errorMsg("No memory for a task stack");
+                t->errors = 1;
+                t->finished = true;
+                continue;
+            }
+            mprotect(t->stack, page, PROT_NONE);
+            getcontext(&t->fiber);
+            t->fiber.uc_stack.ss_sp = t->stack + page;
+            t->fiber.uc_stack.ss_size = FIBER_STACK_SIZE;
+            t->fiber.uc_link = NULL;
+            uintptr_t address = (uintptr_t) t;
+            makecontext(&t->fiber, (void (*)()) taskMain, 2, (unsigned int) (address >> 16 >> 16),
+                        (unsigned int) address);
+            t->started = true;
+            t->wallMs = chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+        }
+        t->back = &home;
+        swapcontext(&home, &t->fiber); // run one quantum
+        if (t->finished) {
+            t->wallMs = chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count()
+                        - t->wallMs;
+            munmap(t->stack, FIBER_STACK_SIZE + page);
+            t->stack = NULL;
+            continue;
+        }
+        t->turn = turn++;
+        ready.push(t);
+    }
+} // end work
@@ -0,0 +1,68 @@
+//
+//  Scheduler.h
+//  MinusMinusV3
+//
+/*
+ Cooperative green thread scheduler. Every ExecutionContext added becomes a
+ task with its own C stack (a ucontext fiber), so a run can be paused at any
+ line and picked up later. A task runs for one quantum of lines, then yields
+ back to its worker, which picks the next task: highest priority first and
+ round robin between tasks of the same priority.
+
+ Each task stays on the worker it was dealt to, so a few OS threads can carry
+ thousands of runs without one runaway script holding up the others. A hard
+ budget per task comes from ExecutionContext::setLimits on the context added.
+ */
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include <ucontext.h>
+#include <vector>
+#include "ExecutionContext.h"
+
+using namespace std;
+
+const int FIBER_STACK_SIZE = 1024 * 1024; // bytes of C stack per task, pages are only touched when used
+
+class Scheduler {
+private:
+    struct Task {
+        ExecutionContext *context;
+        int priority; // higher runs first
+        long turn; // when the task last went to the back of its queue
+        ucontext_t fiber; // where the task was paused
+        ucontext_t *back; // the worker that is running the task
+        char *stack; // mmap'd C stack, guard page at the low end
+        bool started;
+        bool finished;
+        int errors; // what run() returned
+        double wallMs; // first slice to finish
+    };
+    vector<Task *> tasks;
+    int threads; // OS threads used by runAll
+    int quantum; // lines per slice
+
+    static void taskMain(unsigned int high, unsigned int low); // fiber entry, runs the task to the end
+    static void yieldTask(void *task); // ExecutionContext yield hook, back to the worker
+    void work(int worker); // run the tasks dealt to worker until all are done
+
+public:
+    // threads of 0 uses one per hardware thread, quantum is lines per slice
+    Scheduler(int threads = 0, int quantum = 1000);
+
+    ~Scheduler();
+
+    // add context as a task and return its number, context must outlive runAll
+    int add(ExecutionContext &context, int priority = 0);
+
+    // run every task to the end
+    void runAll();
+
+    // errors of task (what run() returned)
+    int getErrors(int task);
+
+    // milliseconds from the first slice of task to its end
+    double getWallMs(int task);
+};
+
+#endif /* Scheduler_h */
@@ -18,7 +18,7 @@ Stack<T>::Stack()
 template<class T>
 bool Stack<T>::push(T value)
 {
-    if (size > STACK_SIZE)
+    if (size >= STACK_SIZE)
         return false;
     values[size] = value;
     size++;
@@ -82,6 +82,15 @@ bool Stack<T>::poke(int index, T value) {
     return true;
 }
 
+// at(index)
+// address of the value at index, NULL if out of range. Good until it is popped
+template<class T>
+T *Stack<T>::at(int index) {
+    if (index < 0 || index >= size)
+        return NULL;
+    return &values[index];
+}
+
 // getStackSize
 // return the number of items on stack
 template<class T>
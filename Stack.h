@@ -41,6 +41,9 @@ public:
     // poke value to stack using the index. Return false if out of range, else true
     bool poke(int index, T value);
     
+    // address of the value at index, NULL if out of range
+    T *at(int index);
+
     // return the number of items on stack
     int getStackSize();
     
@@ -7,6 +7,7 @@
 //
 
 #include "SymbolTable.h"
+#include "RunStats.h"
 
 using namespace std;
 
@@ -22,7 +23,7 @@ Symbol::Symbol() {
     type = NONE;
 }
 
-bool Symbol::operator==(Symbol s) {
+bool Symbol::operator==(const Symbol &s) const {
     return symbol == s.symbol;
 }
 
@@ -50,6 +51,12 @@ ostream &operator<<(ostream &out, const Symbol &t) {
         case VARIABLE:
             out << "variable";
             break;
+        case ARRAY:
+            out << "array";
+            break;
+        case MAP:
+            out << "map";
+            break;
         case NONE:
             out << "none";
             break;
@@ -84,7 +91,7 @@ bool SymbolTable::add(Symbol item) {
 //** get
 // takes Symbol item as a call by reference, uses the symbol to search for the item,
 // if found, updates offset and numeric fields and returns true, else returns false
-bool SymbolTable::get(Symbol &item) {
+bool SymbolTable::get(Symbol &item) const {
     int foundIndex = -1;
     int index = 0;
     bool found = false;
@@ -97,12 +104,16 @@ bool SymbolTable::get(Symbol &item) {
         item = items[foundIndex];
         found = true;
     }
+    if (currentStats != NULL) {
+        currentStats->lookups++;
+        currentStats->probes += index; // symbols compared
+    }
     return found;
 }
 
 //** getSize
 // return the size of the SymbolTable
-int SymbolTable::getSize() {
+int SymbolTable::getSize() const {
     return size;
 }
 
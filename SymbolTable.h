@@ -19,7 +19,7 @@ using std::ostream;
 const int SYMBOLS_SIZE = 200;
 
 enum SymbolType {
-    FUNC, PROC, VARIABLE, NONE
+    FUNC, PROC, VARIABLE, ARRAY, MAP, NONE
 };
 
 // single entry into the SymbolTable
@@ -33,7 +33,7 @@ public:
 
     Symbol();
 
-    bool operator==(Symbol s);
+    bool operator==(const Symbol &s) const;
 
     string getSymbol();
 
@@ -57,10 +57,10 @@ public:
 
     // takes Symbol item as a call by reference, uses the symbol to search for the item,
     // if found, updates offset and numeric fields and returns true, else returns false
-    bool get(Symbol &item);
+    bool get(Symbol &item) const;
 
     // return the size of the SymbolTable
-    int getSize();
+    int getSize() const;
 
     // print the entire SymbolTable
     void printTable();
@@ -0,0 +1,113 @@
+//
+//  ThreadPool.cpp
+//  MinusMinusV3
+//
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numThreads) : queued(0) {
+    pending = 0;
+    stopping = false;
+    next = 0;
+    if (numThreads <= 0)
+        numThreads = thread::hardware_concurrency();
+    if (numThreads <= 0)
+        numThreads = 1; // hardware_concurrency may not know
+    for (int i = 0; i < numThreads; i++)
+        workers.push_back(unique_ptr<Worker>(new Worker));
+    for (int i = 0; i < numThreads; i++)
+        threads.push_back(thread(&ThreadPool::work, this, i));
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        lock_guard<mutex> guard(idleLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (int i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+/** submit
+ input: task
+ output: task is added to the next worker's deque and an idle worker is woken
+ changed: workers, queued and pending
+ */
+void ThreadPool::submit(function<void()> task) {
+    Worker *w;
+    {
+        lock_guard<mutex> guard(idleLock);
+        pending++;
+        w = workers[next % workers.size()].get();
+        next++;
+    }
+    {
+        lock_guard<mutex> guard(w->lock);
+        w->tasks.push_back(task);
+    }
+    queued++;
+    {
+        lock_guard<mutex> guard(idleLock); // the waiter checks queued under this lock
+    }
+    wake.notify_one();
+} // end submit
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(idleLock);
+    done.wait(guard, [this] { return pending == 0; });
+}
+
+int ThreadPool::getThreadCount() {
+    return threads.size();
+}
+
+/** takeTask
+ input: self (index of the worker asking) and task
+ output: take the newest task of worker self or, if there is none, the oldest task of another
+ worker. Return true if task was filled in
+ changed: task, workers and queued
+ */
+bool ThreadPool::takeTask(int self, function<void()> &task) {
+    int count = workers.size();
+    for (int i = 0; i < count; i++) {
+        Worker &w = *workers[(self + i) % count];
+        lock_guard<mutex> guard(w.lock);
+        if (!w.tasks.empty()) {
+            if (i == 0) { // own deque, newest is still warm in cache
+                task = w.tasks.back();
+                w.tasks.pop_back();
+            } else { // steal the oldest
+                task = w.tasks.front();
+                w.tasks.pop_front();
+            }
+            queued--;
+            return true;
+        }
+    }
+    return false;
+} // end takeTask
+
+/** work
+ input: self (index of this worker)
+ output: run tasks until the pool stops, sleeping while there are none
+ */
+void ThreadPool::work(int self) {
+    function<void()> task;
+    while (true) {
+        if (takeTask(self, task)) {
+            task();
+            task = nullptr; // release whatever the task captured
+            lock_guard<mutex> guard(idleLock);
+            pending--;
+            if (pending == 0)
+                done.notify_all();
+            continue;
+        }
+        unique_lock<mutex> guard(idleLock);
+        wake.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+            return;
+    }
+} // end work
@@ -0,0 +1,60 @@
+//
+//  ThreadPool.h
+//  MinusMinusV3
+//
+/*
+ Work stealing thread pool. Every worker has its own deque of tasks;
+ submit() deals tasks out round robin, a worker runs its own tasks newest
+ first and, when it runs dry, steals the oldest task of another worker.
+ */
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool {
+private:
+    struct Worker {
+        mutex lock; // guards tasks
+        deque<function<void()>> tasks;
+    };
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+    mutex idleLock; // guards pending and stopping, used by both condition variables
+    condition_variable wake; // a task was queued or the pool is stopping
+    condition_variable done; // pending reached 0
+    atomic<int> queued; // tasks sitting in some deque
+    int pending; // tasks submitted and not finished
+    bool stopping;
+    unsigned int next; // worker the next submit goes to
+
+    bool takeTask(int self, function<void()> &task); // own deque first, then steal
+    void work(int self); // body of each thread
+
+public:
+    // start numThreads workers, 0 for one per hardware thread
+    ThreadPool(int numThreads = 0);
+
+    // wait for the queued tasks, then stop the workers
+    ~ThreadPool();
+
+    // queue task to run on some worker
+    void submit(function<void()> task);
+
+    // wait until every submitted task has finished
+    void wait();
+
+    // return the number of workers
+    int getThreadCount();
+};
+
+#endif /* ThreadPool_h */
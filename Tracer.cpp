@@ -0,0 +1,60 @@
+//
+//  Tracer.cpp
+//  MinusMinusV3
+//
+
+#include "Tracer.h"
+#include <iomanip>
+
+Tracer::Tracer() : events(TRACE_CAPACITY) {
+    recorded = 0;
+    origin = chrono::steady_clock::now();
+}
+
+/** record
+ input: name, value, start and duration of an event
+ output: store the event over the oldest one once the buffer is full
+ changed: events and recorded
+ */
+void Tracer::record(int name, int value, long long start, long long duration) {
+    Event &e = events[recorded % TRACE_CAPACITY];
+    e.name = name;
+    e.value = value;
+    e.start = start;
+    e.duration = duration;
+    recorded++;
+} // end record
+
+long long Tracer::getDropped() {
+    return recorded > TRACE_CAPACITY ? recorded - TRACE_CAPACITY : 0;
+}
+
+/** write
+ input: prog and out
+ output: write {"traceEvents": [...]} with complete ("X") events for spans and counter
+ ("C") events for the stack size, oldest first, times in microseconds
+ */
+void Tracer::write(const CompiledProgram &prog, ostream &out) {
+    long long first = getDropped();
+    out << "{\"traceEvents\": [" << endl;
+    out << fixed << setprecision(3);
+    for (long long i = first; i < recorded; i++) {
+        Event &e = events[i % TRACE_CAPACITY];
+        out << (i > first ? ",\n" : "");
+        if (e.duration < 0) {
+            out << "{\"name\": \"stack\", \"ph\": \"C\", \"pid\": 1, \"tid\": 1, \"ts\": " << e.start / 1000.0
+                << ", \"args\": {\"size\": " << e.value << "}}";
+            continue;
+        }
+        string name, category = "call";
+        if (e.name == TRACE_INPUT)
+            name = category = "input";
+        else if (e.name == TRACE_FLUSH)
+            name = category = "flush";
+        else
+            name = prog.getMethodName(e.name);
+        out << "{\"name\": \"" << name << "\", \"cat\": \"" << category << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, "
+            << "\"ts\": " << e.start / 1000.0 << ", \"dur\": " << e.duration / 1000.0 << "}";
+    }
+    out << endl << "], \"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped\": " << first << "}}" << endl;
+} // end write
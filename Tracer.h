@@ -0,0 +1,67 @@
+//
+//  Tracer.h
+//  MinusMinusV3
+//
+/*
+ Records a run as Chrome trace events (chrome://tracing or Perfetto): a span
+ for every FUNCTION and PROCEDURE call, for every INPUT wait and for every
+ output flush, and a counter of the stack size at each call and return.
+
+ Events go into a ring buffer allocated by the constructor, so recording is a
+ clock read and a few stores; when the buffer is full the oldest events are
+ overwritten. Nothing is formatted until write is called after the run.
+ */
+#ifndef Tracer_h
+#define Tracer_h
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "CompiledProgram.h"
+
+using namespace std;
+
+const int TRACE_CAPACITY = 1 << 18; // events kept, the newest win
+const int TRACE_INPUT = -2; // span name of an INPUT wait
+const int TRACE_FLUSH = -3; // span name of an output flush
+
+class Tracer {
+private:
+    struct Event {
+        int name; // heading line of a method, TRACE_INPUT or TRACE_FLUSH; -1 for a stack counter
+        int value; // stack size of a counter
+        long long start; // ns since the tracer was made
+        long long duration; // ns of a span, -1 for a counter
+    };
+    vector<Event> events; // ring buffer
+    long long recorded; // events ever recorded, next goes to recorded % TRACE_CAPACITY
+    chrono::steady_clock::time_point origin;
+
+    void record(int name, int value, long long start, long long duration);
+
+public:
+    Tracer();
+
+    // ns since the tracer was made, the start of a span
+    long long now() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+    }
+
+    // a span named name (method heading line, TRACE_INPUT or TRACE_FLUSH) that began at start ends now
+    void span(int name, long long start) {
+        record(name, 0, start, now() - start);
+    }
+
+    // the stack holds size values now
+    void stackSize(int size) {
+        record(-1, size, now(), -1);
+    }
+
+    // return how many events were lost because the buffer was full
+    long long getDropped();
+
+    // write the events kept as a trace event JSON file, method names from prog
+    void write(const CompiledProgram &prog, ostream &out);
+};
+
+#endif /* Tracer_h */
@@ -0,0 +1,246 @@
+//
+//  mm_bench.cpp
+//  MinusMinusV3
+//
+/*
+ Runs the benchmark workloads: every .mm file in a directory (bench/workloads
+ by default) with name.expected holding its exact output and name.in, when
+ there is one, as its INPUT. Each workload is loaded once, run once to warm
+ up and then reps times in a fresh ExecutionContext. A run whose output is
+ not the expected output fails the benchmark.
+
+ Prints a table and writes JSON (--json file) with the median, p99, mean and
+ standard deviation of the run times, statements per second at the median
+ and the peak resident set size while the workload ran. On Linux the kernel's
+ high water mark (VmHWM) is reset before each workload; where it can not be,
+ the peak is the whole process's so far, which never goes down, and the table
+ and JSON say so. The JSON
+ also has the run's deterministic work counts (see RunStats), which must be
+ the same for every run of a workload, as a timing free signal.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/resource.h>
+#include <vector>
+#include "BatchRunner.h"
+#include "CompiledProgram.h"
+#include "ExecutionContext.h"
+#include "support.hpp"
+
+#ifndef MM_BENCH_DIR
+#define MM_BENCH_DIR "bench/workloads"
+#endif
+
+// what one workload measured
+struct BenchResult {
+    string name;
+    bool ok; // loaded and every run printed the expected output
+    vector<double> ms; // time of each run
+    double median, p99, mean, stddev;
+    long statements; // lines dispatched by one run
+    RunStats counts; // work of one run
+    bool deterministic; // every run counted the same work
+    long peakRssKb; // high water while the workload ran, or of the process so far
+    bool rssPerWorkload; // false when peakRssKb is the process's
+
+    BenchResult() : ok(false), median(0), p99(0), mean(0), stddev(0), statements(0), deterministic(true),
+                    peakRssKb(0), rssPerWorkload(false) {}
+};
+
+/** resetPeakRss
+ output: reset this process's peak resident set size, return false if it can not be
+ (needs Linux 4.0 or later)
+ */
+static bool resetPeakRss() {
+    ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5" << flush;
+    return !clearRefs.fail();
+} // end resetPeakRss
+
+/** peakRss
+ output: peak resident set size in KB since the last resetPeakRss, from VmHWM in
+ /proc/self/status, or the process peak from getrusage when that can not be read
+ */
+static long peakRss() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return atol(line.c_str() + 6);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kilobytes on Linux
+} // end peakRss
+
+/** readFile
+ input: path and contents
+ output: fill contents with the file, return false if it could not be read
+ changed: contents
+ */
+static bool readFile(string path, string &contents) {
+    ifstream file(path.c_str());
+    if (file.fail())
+        return false;
+    ostringstream all;
+    all << file.rdbuf();
+    contents = all.str();
+    return true;
+} // end readFile
+
+/** summarize
+ input: result with its run times
+ output: fill in median, p99 (nearest rank), mean and standard deviation
+ changed: result
+ */
+static void summarize(BenchResult &result) {
+    vector<double> sorted = result.ms;
+    sort(sorted.begin(), sorted.end());
+    int n = sorted.size();
+    result.median = result.p99 = result.mean = result.stddev = 0;
+    if (n == 0)
+        return;
+    result.median = n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    result.p99 = sorted[(int) ceil(0.99 * n) - 1];
+    for (int i = 0; i < n; i++)
+        result.mean += sorted[i];
+    result.mean /= n;
+    for (int i = 0; i < n; i++)
+        result.stddev += (sorted[i] - result.mean) * (sorted[i] - result.mean);
+    result.stddev = n > 1 ? sqrt(result.stddev / (n - 1)) : 0;
+} // end summarize
+
+/** benchmark
+ input: job (script and INPUT file) and reps
+ output: load the script, run it 1 + reps times checking its output and return the timings
+ */
+static BenchResult benchmark(BatchJob &job, int reps) {
+    BenchResult result;
+    result.name = job.name.substr(job.name.find('_') + 1);
+    result.rssPerWorkload = resetPeakRss();
+    string expected, input;
+    string base = job.script.substr(0, job.script.length() - 3);
+    if (!readFile(base + ".expected", expected)) {
+        cerr << result.name << ": no " << base << ".expected" << endl;
+        expected = "\1"; // nothing matches
+    }
+    if (job.input != "")
+        readFile(job.input, input);
+    unique_ptr<CompiledProgram> prog(new CompiledProgram);
+    ifstream inFile(job.script.c_str());
+    ostringstream loadMessages;
+    if (!prog->loadProg(inFile, false, loadMessages) || prog->getLoadErrors() > 0) {
+        cerr << result.name << ": could not load" << endl << loadMessages.str();
+        return result;
+    }
+    result.ok = true;
+    for (int rep = 0; rep <= reps; rep++) { // rep 0 warms up and is not timed
+        istringstream in(input);
+        ostringstream out;
+        ExecutionContext context(*prog);
+        context.setIO(in, out);
+        context.setErrorStream(out);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        run(context);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (out.str() != expected) {
+            if (result.ok)
+                cerr << result.name << ": output differs from " << base << ".expected" << endl;
+            result.ok = false;
+        }
+        result.statements = context.getStatementCount();
+        RunStats &counts = context.getStats();
+        if (rep > 0 && (counts.lines != result.counts.lines || counts.operations != result.counts.operations
+                        || counts.calls != result.counts.calls || counts.lookups != result.counts.lookups
+                        || counts.allocations != result.counts.allocations)) {
+            if (result.deterministic)
+                cerr << result.name << ": work counts differ between runs" << endl;
+            result.deterministic = false;
+        }
+        result.counts = counts;
+        if (rep > 0)
+            result.ms.push_back(ms);
+    }
+    summarize(result);
+    result.peakRssKb = peakRss();
+    return result;
+} // end benchmark
+
+/** writeJson
+ input: results, reps and out
+ output: write the results as {"reps": n, "benchmarks": [...]}
+ */
+static void writeJson(vector<BenchResult> &results, int reps, ostream &out) {
+    out << fixed << setprecision(4);
+    out << "{\"reps\": " << reps << ", \"benchmarks\": [" << endl;
+    for (int i = 0; i < results.size(); i++) {
+        BenchResult &r = results[i];
+        out << "  {\"name\": \"" << r.name << "\", \"ok\": " << (r.ok ? "true" : "false")
+            << ", \"median_ms\": " << r.median << ", \"p99_ms\": " << r.p99
+            << ", \"mean_ms\": " << r.mean << ", \"stddev_ms\": " << r.stddev
+            << ", \"statements\": " << r.statements
+            << ", \"statements_per_s\": " << (r.median > 0 ? r.statements / (r.median / 1000) : 0)
+            << ", \"peak_rss_kb\": " << r.peakRssKb
+            << ", \"peak_rss_scope\": \"" << (r.rssPerWorkload ? "workload" : "process") << "\""
+            << ", \"deterministic\": " << (r.deterministic ? "true" : "false") << ", \"counts\": ";
+        printCounts(r.counts, out);
+        out << ", \"samples_ms\": [";
+        for (int j = 0; j < r.ms.size(); j++)
+            out << (j > 0 ? ", " : "") << r.ms[j];
+        out << "]}" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    out << "]}" << endl;
+} // end writeJson
+
+int main(int argc, char *argv[]) {
+    string dir = MM_BENCH_DIR, jsonFile;
+    int reps = 10;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+            reps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonFile = argv[++i];
+        else if (argv[i][0] != '-')
+            dir = argv[i];
+        else {
+            cout << "usage: " << argv[0] << " [--reps n] [--json file] [workload directory]" << endl;
+            return 1;
+        }
+    }
+    if (reps < 1)
+        reps = 1;
+    vector<BatchJob> jobs;
+    if (!readJobs(dir, jobs) || jobs.empty()) {
+        cout << "No workloads in " << dir << endl;
+        return 1;
+    }
+    vector<BenchResult> results;
+    int failed = 0;
+    cout << "workload        median ms     p99 ms   statements/s  peak RSS KB" << endl;
+    for (int i = 0; i < jobs.size(); i++) {
+        results.push_back(benchmark(jobs[i], reps));
+        BenchResult &r = results.back();
+        if (!r.ok)
+            failed++;
+        cout << left << setw(14) << r.name << right << fixed << setprecision(3) << setw(11) << r.median
+             << setw(11) << r.p99 << setprecision(0) << setw(15) << (r.median > 0 ? r.statements / (r.median / 1000) : 0)
+             << setw(13) << r.peakRssKb << (r.rssPerWorkload ? "" : " (process)") << (r.ok ? "" : "  FAILED") << endl;
+    }
+    if (jsonFile != "") {
+        ofstream json(jsonFile.c_str());
+        writeJson(results, reps, json);
+        if (json.fail()) {
+            cout << "Could not write " << jsonFile << endl;
+            return 1;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,319 @@
+//
+//  mm_benchcmp.cpp
+//  MinusMinusV3
+//
+/*
+ Compares two benchmark JSON files written by mm_bench or mm_microbench, a
+ baseline and a current run, and exits with 1 when any benchmark got
+ significantly slower, failed in the current run ("ok": false, wrong output
+ or not loaded) or is missing from it (2 when a file cannot be read). A
+ failed run's times are not compared, and neither are times against a
+ baseline that failed.
+
+ A benchmark is significantly slower when its median grew by more than its
+ threshold: sigma times the combined noise of the two runs, but never less
+ than --threshold percent. The noise of a run is the median absolute
+ deviation of its samples (scaled to a standard deviation), or its stddev
+ when the file has no samples, so one unlucky rep does not widen it.
+
+ Files from mm_bench also hold deterministic work counts. Those have no
+ noise, so every count that changed is listed under the table; they explain
+ a timing change but do not change the exit code.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// just enough JSON for the benchmark files
+struct JsonValue {
+    enum Kind {
+        NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT
+    } kind;
+    double number;
+    string text;
+    vector<JsonValue> items;
+    map<string, JsonValue> fields;
+
+    JsonValue() : kind(NUL), number(0) {}
+
+    // the field called name, a null value when there is none
+    const JsonValue &operator[](const string &name) const {
+        static JsonValue missing;
+        map<string, JsonValue>::const_iterator it = fields.find(name);
+        return it == fields.end() ? missing : it->second;
+    }
+};
+
+class JsonReader {
+private:
+    const string &s;
+    size_t at;
+
+    void skipSpace() {
+        while (at < s.length() && isspace((unsigned char) s[at]))
+            at++;
+    }
+
+    bool expect(char c) {
+        skipSpace();
+        if (at < s.length() && s[at] == c) {
+            at++;
+            return true;
+        }
+        return false;
+    }
+
+    bool readString(string &out) {
+        if (!expect('"'))
+            return false;
+        out = "";
+        while (at < s.length() && s[at] != '"') {
+            if (s[at] == '\\' && at + 1 < s.length())
+                at++;
+            out += s[at++];
+        }
+        return expect('"');
+    }
+
+public:
+    JsonReader(const string &text) : s(text), at(0) {}
+
+    /** read
+     input: value
+     output: read the next value into value, false if the text is not JSON
+     changed: value
+     */
+    bool read(JsonValue &value) {
+        skipSpace();
+        if (at >= s.length())
+            return false;
+        char c = s[at];
+        if (c == '{') {
+            value.kind = JsonValue::OBJECT;
+            at++;
+            if (expect('}'))
+                return true;
+            do {
+                string name;
+                if (!readString(name) || !expect(':') || !read(value.fields[name]))
+                    return false;
+            } while (expect(','));
+            return expect('}');
+        }
+        if (c == '[') {
+            value.kind = JsonValue::ARRAY;
+            at++;
+            if (expect(']'))
+                return true;
+            do {
+                value.items.push_back(JsonValue());
+                if (!read(value.items.back()))
+                    return false;
+            } while (expect(','));
+            return expect(']');
+        }
+        if (c == '"') {
+            value.kind = JsonValue::STRING;
+            return readString(value.text);
+        }
+        if (s.compare(at, 4, "true") == 0 || s.compare(at, 5, "false") == 0) {
+            value.kind = JsonValue::BOOL;
+            value.number = s[at] == 't';
+            at += s[at] == 't' ? 4 : 5;
+            return true;
+        }
+        if (s.compare(at, 4, "null") == 0) {
+            at += 4;
+            return true;
+        }
+        char *end;
+        value.kind = JsonValue::NUMBER;
+        value.number = strtod(s.c_str() + at, &end);
+        if (end == s.c_str() + at)
+            return false;
+        at = end - s.c_str();
+        return true;
+    }
+};
+
+// the figures of one benchmark in one file
+struct Measured {
+    bool ok; // false when mm_bench marked it failed, its times mean nothing
+    double median;
+    double noise; // robust standard deviation of the samples
+    map<string, double> counts; // deterministic work counts, empty when the file has none
+};
+
+/** noiseOf
+ input: a benchmark object and the unit suffix of its fields
+ output: 1.4826 * median absolute deviation of its samples, or its stddev without samples
+ */
+static double noiseOf(const JsonValue &bench, string unit) {
+    const JsonValue &samples = bench["samples_" + unit];
+    if (samples.items.size() < 3)
+        return bench["stddev_" + unit].number;
+    vector<double> v;
+    for (int i = 0; i < samples.items.size(); i++)
+        v.push_back(samples.items[i].number);
+    sort(v.begin(), v.end());
+    double median = v[v.size() / 2];
+    for (int i = 0; i < v.size(); i++)
+        v[i] = fabs(v[i] - median);
+    sort(v.begin(), v.end());
+    return 1.4826 * v[v.size() / 2];
+} // end noiseOf
+
+/** readResults
+ input: path, results and unit
+ output: fill results with the median and noise of every benchmark in the file and set unit
+ to "ms" or "ns". Return false if the file could not be read
+ changed: results and unit
+ */
+static bool readResults(string path, map<string, Measured> &results, vector<string> &order, string &unit) {
+    ifstream file(path.c_str());
+    if (file.fail()) {
+        cout << "Could not open " << path << endl;
+        return false;
+    }
+    ostringstream text;
+    text << file.rdbuf();
+    string contents = text.str();
+    JsonValue root;
+    JsonReader reader(contents);
+    if (!reader.read(root) || root["benchmarks"].kind != JsonValue::ARRAY) {
+        cout << path << " is not a benchmark JSON file" << endl;
+        return false;
+    }
+    const vector<JsonValue> &benchmarks = root["benchmarks"].items;
+    for (int i = 0; i < benchmarks.size(); i++) {
+        const JsonValue &bench = benchmarks[i];
+        string thisUnit = bench["median_ms"].kind == JsonValue::NUMBER ? "ms" : "ns";
+        if (bench["median_" + thisUnit].kind != JsonValue::NUMBER)
+            continue;
+        unit = thisUnit;
+        Measured m;
+        m.ok = bench["ok"].kind != JsonValue::BOOL || bench["ok"].number != 0; // mm_microbench has no "ok"
+        m.median = bench["median_" + unit].number;
+        m.noise = noiseOf(bench, unit);
+        const map<string, JsonValue> &counts = bench["counts"].fields;
+        for (map<string, JsonValue>::const_iterator it = counts.begin(); it != counts.end(); it++)
+            m.counts[it->first] = it->second.number;
+        results[bench["name"].text] = m;
+        order.push_back(bench["name"].text);
+    }
+    return true;
+} // end readResults
+
+int main(int argc, char *argv[]) {
+    vector<string> files;
+    double minPercent = 5; // never flag less than this
+    double sigma = 3; // noise multiples a slowdown must pass
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+            minPercent = atof(argv[++i]);
+        else if (strcmp(argv[i], "--sigma") == 0 && i + 1 < argc)
+            sigma = atof(argv[++i]);
+        else if (argv[i][0] != '-')
+            files.push_back(argv[i]);
+        else
+            usage = true;
+    }
+    if (usage || files.size() != 2) {
+        cout << "usage: " << argv[0] << " baseline.json current.json [--threshold percent] [--sigma k]" << endl;
+        return 2;
+    }
+    map<string, Measured> baseline, current;
+    vector<string> baseOrder, order;
+    string baseUnit, unit;
+    if (!readResults(files[0], baseline, baseOrder, baseUnit) || !readResults(files[1], current, order, unit))
+        return 2;
+    if (baseUnit != "" && unit != "" && baseUnit != unit) {
+        cout << "The files hold different kinds of benchmark (" << baseUnit << " and " << unit << ")" << endl;
+        return 2;
+    }
+    for (int i = 0; i < baseOrder.size(); i++)
+        if (current.find(baseOrder[i]) == current.end())
+            order.push_back(baseOrder[i]);
+
+    int slower = 0, failed = 0; // failed: not ok or missing in the current run
+    cout << left << setw(32) << "benchmark" << right << setw(13) << "baseline " + unit << setw(13)
+         << "current " + unit << setw(10) << "delta" << setw(11) << "threshold" << "  verdict" << endl;
+    for (int i = 0; i < order.size(); i++) {
+        string name = order[i];
+        map<string, Measured>::iterator base = baseline.find(name), cur = current.find(name);
+        cout << left << setw(32) << name << right << fixed << setprecision(3);
+        if (base == baseline.end()) {
+            cout << setw(13) << "-" << setw(13) << cur->second.median << setw(10) << "-" << setw(11) << "-"
+                 << (cur->second.ok ? "  new" : "  FAILED") << endl;
+            if (!cur->second.ok)
+                failed++;
+            continue;
+        }
+        if (cur == current.end()) {
+            cout << setw(13) << base->second.median << setw(13) << "-" << setw(10) << "-" << setw(11) << "-"
+                 << "  MISSING" << endl;
+            failed++;
+            continue;
+        }
+        if (!cur->second.ok || !base->second.ok) {
+            cout << setw(13) << base->second.median << setw(13) << cur->second.median << setw(10) << "-"
+                 << setw(11) << "-" << (cur->second.ok ? "  baseline failed" : "  FAILED") << endl;
+            if (!cur->second.ok)
+                failed++;
+            continue;
+        }
+        double b = base->second.median, c = cur->second.median;
+        double delta = b > 0 ? 100 * (c - b) / b : 0;
+        double noise = sqrt(base->second.noise * base->second.noise + cur->second.noise * cur->second.noise);
+        double threshold = max(minPercent, b > 0 ? 100 * sigma * noise / b : 0);
+        string verdict = "same";
+        if (delta > threshold) {
+            verdict = "SLOWER";
+            slower++;
+        } else if (-delta > threshold)
+            verdict = "faster";
+        ostringstream d, t;
+        d << fixed << setprecision(1) << showpos << delta << "%";
+        t << fixed << setprecision(1) << threshold << "%";
+        cout << setw(13) << b << setw(13) << c << setw(10) << d.str() << setw(11) << t.str() << "  " << verdict
+             << endl;
+    }
+    bool countsShown = false;
+    for (int i = 0; i < order.size(); i++) {
+        map<string, Measured>::iterator base = baseline.find(order[i]), cur = current.find(order[i]);
+        if (base == baseline.end() || cur == current.end())
+            continue;
+        map<string, double> &was = base->second.counts, &now = cur->second.counts;
+        for (map<string, double>::iterator it = was.begin(); it != was.end(); it++) {
+            if (now.find(it->first) == now.end() || now[it->first] == it->second)
+                continue;
+            if (!countsShown)
+                cout << endl << "Work counts that changed" << endl;
+            countsShown = true;
+            ostringstream d;
+            d << fixed << setprecision(1) << showpos
+              << (it->second != 0 ? 100 * (now[it->first] - it->second) / it->second : 0) << "%";
+            cout << left << setw(32) << order[i] + " " + it->first << right << fixed << setprecision(0)
+                 << setw(13) << it->second << setw(13) << now[it->first] << setw(10) << d.str() << endl;
+        }
+    }
+    cout << slower << " of " << order.size() << " benchmarks significantly slower";
+    if (failed > 0)
+        cout << ", " << failed << " failed or missing";
+    cout << endl;
+    return slower > 0 || failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+//
+//  mm_microbench.cpp
+//  MinusMinusV3
+//
+/*
+ Micro-benchmarks of the interpreter's primitives, so a change to the hot
+ path shows which one got slower: the tokenizer for every Extract mode,
+ nextFactor, parseEquation (with calculate) on growing expressions,
+ SymbolTable add and get at growing sizes, Stack push and pop and the array
+ kernels for every instruction set this CPU runs. Operations that need a
+ fresh structure (SymbolTable::add, Stack) include making it.
+
+ Each benchmark is calibrated first (the loop count doubles until one rep
+ takes BENCH_REP_NS, which also warms it up), then timed for reps reps. The
+ figure reported is nanoseconds per operation: median, p99, mean and
+ standard deviation over the reps. --json writes them for comparison.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "ArrayKernels.h"
+#include "CompiledProgram.h"
+#include "ExecutionContext.h"
+#include "Stack.h"
+#include "support.hpp"
+#include "SymbolTable.h"
+
+const long long BENCH_REP_NS = 5000000; // calibrated length of one rep
+
+volatile long benchSink; // results go here so the compiler keeps the work
+
+// what one benchmark measured, per operation
+struct MicroResult {
+    string name;
+    vector<double> ns; // ns per operation of each rep
+    double median, p99, mean, stddev;
+    long loops; // operations per rep
+};
+
+/** timeLoops
+ input: body and loops
+ output: run body loops times and return the ns taken
+ */
+static long long timeLoops(function<void()> &body, long loops) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (long i = 0; i < loops; i++)
+        body();
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+} // end timeLoops
+
+/** measure
+ input: name, body (one operation) and reps
+ output: calibrate the loop count, time reps reps and return ns per operation
+ */
+static MicroResult measure(string name, function<void()> body, int reps) {
+    MicroResult result;
+    result.name = name;
+    result.loops = 1;
+    while (timeLoops(body, result.loops) < BENCH_REP_NS && result.loops < (1L << 30))
+        result.loops *= 2;
+    for (int rep = 0; rep < reps; rep++)
+        result.ns.push_back((double) timeLoops(body, result.loops) / result.loops);
+    vector<double> sorted = result.ns;
+    sort(sorted.begin(), sorted.end());
+    int n = sorted.size();
+    result.median = n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    result.p99 = sorted[(int) ceil(0.99 * n) - 1];
+    result.mean = result.stddev = 0;
+    for (int i = 0; i < n; i++)
+        result.mean += sorted[i];
+    result.mean /= n;
+    for (int i = 0; i < n; i++)
+        result.stddev += (sorted[i] - result.mean) * (sorted[i] - result.mean);
+    result.stddev = n > 1 ? sqrt(result.stddev / (n - 1)) : 0;
+    return result;
+} // end measure
+
+/** symbolName
+ input: i
+ output: a variable name unique to i
+ */
+static string symbolName(int i) {
+    return "var" + to_string(i);
+} // end symbolName
+
+/** expression
+ input: terms
+ output: an expression over the variables a, b and c with terms operands, every fourth
+ term in parentheses
+ */
+static string expression(int terms) {
+    const char *operands[] = {"a", "b", "c", "7"};
+    const char *operators[] = {" + ", " * ", " - ", " % "};
+    string exp = "a";
+    for (int i = 1; i < terms; i++) {
+        string operand = operands[i % 4];
+        if (i % 4 == 3)
+            operand = "(" + operand + " + 3)";
+        exp += operators[i % 4] + operand;
+    }
+    return exp;
+} // end expression
+
+int main(int argc, char *argv[]) {
+    string jsonFile, filter;
+    int reps = 20;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+            reps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonFile = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else {
+            cout << "usage: " << argv[0] << " [--reps n] [--json file] [--filter name part]" << endl;
+            return 1;
+        }
+    }
+    if (reps < 1)
+        reps = 1;
+
+    unique_ptr<CompiledProgram> prog(new CompiledProgram); // empty, the benchmarks run no lines
+    ExecutionContext context(*prog);
+    SymbolTable local;
+    context.push(0); // dummy return, as run() does
+    context.push("a", local);
+    context.push("b", local);
+    context.push("c", local);
+    context.poke("a", 12, local);
+    context.poke("b", 5, local);
+    context.poke("c", 3, local);
+
+    vector<pair<string, function<void()>>> benchmarks;
+
+    // the tokenizer, one representative line per Extract mode
+    struct TokenCase {
+        const char *name;
+        Extract mode;
+        const char *line;
+    };
+    TokenCase tokenCases[] = {
+            {"BOOLEAN",   BOOLEAN,   "total + i * 2 <= limit - 1"},
+            {"CMD",       CMD,       "total := total + i * 2 - 1"},
+            {"COMMA",     COMMA,     "\"total = \", total, \" of \", n"},
+            {"COMPARE",   COMPARE,   "a % 7 <> b"},
+            {"EQUATION",  EQUATION,  "total + i * 2 - 1"},
+            {"LINE",      LINE,      "fib(k - 1) + fib(k - 2)"},
+            {"PARMS",     PARMS,     "(a, b, c)"},
+            {"OPEN_PARM", OPEN_PARM, "fib(k - 1)"},
+            {"STRING",    STRING,    "\"hello\" rest"},
+            {"TOKEN",     TOKEN,     "WHILE i < 10"}};
+    for (int i = 0; i < sizeof(tokenCases) / sizeof(tokenCases[0]); i++) {
+        TokenCase c = tokenCases[i];
+        benchmarks.push_back(make_pair(string("nextToken/") + c.name, [&context, c] {
+            context.setLine(c.line); // each operation starts from the whole line
+            benchSink += (context -= c.mode).length();
+        }));
+    }
+
+    // nextFactor through whole expressions, then parse and calculate them
+    int sizes[] = {2, 8, 32};
+    for (int i = 0; i < 3; i++) {
+        string exp = expression(sizes[i]);
+        benchmarks.push_back(make_pair("nextFactor/" + to_string(sizes[i]) + "_terms", [&context, exp] {
+            string s = exp;
+            while (!context.nextFactor(s).empty())
+                benchSink++;
+        }));
+        benchmarks.push_back(make_pair("parseEquation/" + to_string(sizes[i]) + "_terms", [&context, &local, exp] {
+            bool success;
+            benchSink += parseEquation(context, exp, local, success);
+        }));
+    }
+
+    // SymbolTable at growing sizes. 1000 would be past SYMBOLS_SIZE, so the last size is a full table
+    int tableSizes[] = {10, 100, SYMBOLS_SIZE};
+    for (int i = 0; i < 3; i++) {
+        int n = tableSizes[i];
+        shared_ptr<vector<Symbol>> symbols(new vector<Symbol>);
+        for (int j = 0; j < n; j++)
+            symbols->push_back(Symbol(symbolName(j), j, VARIABLE));
+        benchmarks.push_back(make_pair("SymbolTable::add/" + to_string(n), [symbols] {
+            SymbolTable table; // one operation makes and fills a table, add is checked for duplicates so it grows with n
+            for (int j = 0; j < symbols->size(); j++)
+                table.add((*symbols)[j]);
+            benchSink += table.getSize();
+        }));
+        shared_ptr<SymbolTable> table(new SymbolTable);
+        for (int j = 0; j < n; j++)
+            table->add((*symbols)[j]);
+        shared_ptr<int> next(new int(0));
+        benchmarks.push_back(make_pair("SymbolTable::get/" + to_string(n), [symbols, table, next] {
+            Symbol s((*symbols)[*next].getSymbol(), 0, NONE); // every entry in turn
+            *next = (*next + 1) % symbols->size();
+            benchSink += table->get(s);
+        }));
+    }
+
+    // Stack push then pop to empty, a full STACK_SIZE of values
+    benchmarks.push_back(make_pair("Stack<int>::push_pop/" + to_string(STACK_SIZE), [] {
+        Stack<int> stack;
+        for (int j = 0; j < STACK_SIZE; j++)
+            stack.push(j);
+        while (stack.getStackSize() > 0) {
+            benchSink += stack.peek();
+            stack.pop();
+        }
+    }));
+    benchmarks.push_back(make_pair("Stack<string>::push_pop/" + to_string(STACK_SIZE), [] {
+        Stack<string> stack;
+        string value = "total";
+        for (int j = 0; j < STACK_SIZE; j++)
+            stack.push(value);
+        while (stack.getStackSize() > 0) {
+            benchSink += stack.peek().length();
+            stack.pop();
+        }
+    }));
+
+    // the array kernels over ARRAY_BENCH_SIZE values, once per kernel set this CPU can run
+    const int ARRAY_BENCH_SIZE = 10000;
+    shared_ptr<vector<int>> values(new vector<int>(ARRAY_BENCH_SIZE)), others(new vector<int>(ARRAY_BENCH_SIZE));
+    for (int j = 0; j < ARRAY_BENCH_SIZE; j++) {
+        (*values)[j] = j * 7919 % 2001 - 1000;
+        (*others)[j] = j % 13;
+    }
+    const char *kernelSets[] = {"scalar", "sse2", "avx2"};
+    for (int i = 0; i < 3; i++) {
+        if (!selectArrayKernels(kernelSets[i]))
+            continue;
+        const ArrayKernels *kernels = &arrayKernels();
+        string suffix = string("/") + kernels->name + "/" + to_string(ARRAY_BENCH_SIZE);
+        benchmarks.push_back(make_pair("array::sum" + suffix, [kernels, values] {
+            benchSink += kernels->sum(values->data(), values->size());
+        }));
+        benchmarks.push_back(make_pair("array::minof" + suffix, [kernels, values] {
+            benchSink += kernels->minOf(values->data(), values->size());
+        }));
+        benchmarks.push_back(make_pair("array::dot" + suffix, [kernels, values, others] {
+            benchSink += kernels->dot(values->data(), others->data(), values->size());
+        }));
+        benchmarks.push_back(make_pair("array::prefixsum" + suffix, [kernels, others] {
+            vector<int> &v = *others; // sums wrap, so running it again and again is fine
+            benchSink += kernels->prefixSum(v.data(), v.size());
+        }));
+        benchmarks.push_back(make_pair("array::fill" + suffix, [kernels, others] {
+            kernels->fill(others->data(), others->size(), 3);
+            benchSink += (*others)[0];
+        }));
+    }
+
+    vector<MicroResult> results;
+    cout << "benchmark                          median ns     p99 ns  stddev ns" << endl;
+    for (int i = 0; i < benchmarks.size(); i++) {
+        if (filter != "" && benchmarks[i].first.find(filter) == string::npos)
+            continue;
+        results.push_back(measure(benchmarks[i].first, benchmarks[i].second, reps));
+        MicroResult &r = results.back();
+        cout << left << setw(32) << r.name << right << fixed << setprecision(1) << setw(13) << r.median
+             << setw(11) << r.p99 << setw(11) << r.stddev << endl;
+    }
+    if (context.getErrorCount() > 0) {
+        cout << "The benchmarks caused interpreter errors" << endl;
+        return 1;
+    }
+    if (jsonFile != "") {
+        ofstream json(jsonFile.c_str());
+        json << fixed << setprecision(2);
+        json << "{\"reps\": " << reps << ", \"benchmarks\": [" << endl;
+        for (int i = 0; i < results.size(); i++) {
+            MicroResult &r = results[i];
+            json << "  {\"name\": \"" << r.name << "\", \"loops\": " << r.loops << ", \"median_ns\": " << r.median
+                 << ", \"p99_ns\": " << r.p99 << ", \"mean_ns\": " << r.mean << ", \"stddev_ns\": " << r.stddev
+                 << ", \"samples_ns\": [";
+            for (int j = 0; j < r.ns.size(); j++)
+                json << (j > 0 ? ", " : "") << r.ns[j];
+            json << "]}" << (i + 1 < results.size() ? "," : "") << endl;
+        }
+        json << "]}" << endl;
+        if (json.fail()) {
+            cout << "Could not write " << jsonFile << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+//
+//  mm_stress.cpp
+//  MinusMinusV3
+//
+/*
+ Stress test for running many interpreters at once: one CompiledProgram
+ (bench/stress/stress.mm by default) is loaded, every seed is run once on
+ its own to get the reference output, then several threads run it again and
+ again in fresh ExecutionContexts that all share that program. Every run must
+ print exactly its seed's reference output (errors included), so rand, INPUT,
+ PRINT, GLOBALs, arrays, maps and error counts can not leak between contexts.
+ Exits with 1 on any difference.
+
+ Build it with ThreadSanitizer to check the shared program is only read:
+   cmake -S . -B build-tsan -DCMAKE_BUILD_TYPE=RelWithDebInfo \
+         -DCMAKE_CXX_FLAGS="-fsanitize=thread" -DCMAKE_EXE_LINKER_FLAGS="-fsanitize=thread"
+   cmake --build build-tsan --target mm_stress && build-tsan/mm_stress
+ TSan reports any data race on stderr and makes the exit code non zero.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "CompiledProgram.h"
+#include "ExecutionContext.h"
+#include "support.hpp"
+
+#ifndef MM_STRESS_SCRIPT
+#define MM_STRESS_SCRIPT "bench/stress/stress.mm"
+#endif
+
+/** runOnce
+ input: the shared program, its INPUT and a seed for rand
+ output: run the program in a fresh ExecutionContext and return everything it printed
+ */
+static string runOnce(const CompiledProgram &prog, const string &input, unsigned int seed) {
+    istringstream in(input);
+    ostringstream out;
+    ExecutionContext context(prog, seed);
+    context.setIO(in, out);
+    context.setErrorStream(out);
+    out << run(context) << " errors" << endl;
+    return out.str();
+} // end runOnce
+
+int main(int argc, char *argv[]) {
+    string script = MM_STRESS_SCRIPT;
+    int threads = 8, rounds = 10, seeds = 4;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc)
+            seeds = atoi(argv[++i]);
+        else if (argv[i][0] != '-')
+            script = argv[i];
+        else {
+            cout << "usage: " << argv[0] << " [--threads n] [--rounds n] [--seeds n] [script.mm]" << endl;
+            return 1;
+        }
+    }
+    if (threads < 1 || rounds < 1 || seeds < 1) {
+        cout << "threads, rounds and seeds must be at least 1" << endl;
+        return 1;
+    }
+
+    CompiledProgram prog;
+    ostringstream loadMessages;
+    ifstream inFile(script.c_str());
+    if (!prog.loadProg(inFile, false, loadMessages) || prog.getLoadErrors() > 0) {
+        cerr << script << ": could not load" << endl << loadMessages.str();
+        return 1;
+    }
+    string input; // name.in, if there is one
+    ifstream inputFile((script.substr(0, script.length() - 3) + ".in").c_str());
+    if (!inputFile.fail()) {
+        ostringstream all;
+        all << inputFile.rdbuf();
+        input = all.str();
+    }
+
+    vector<string> expected; // reference output of each seed, run alone
+    for (int seed = 0; seed < seeds; seed++)
+        expected.push_back(runOnce(prog, input, seed + 1));
+
+    atomic<int> differences(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++)
+        workers.push_back(thread([&, t] {
+            for (int round = 0; round < rounds; round++) {
+                int seed = (t + round) % seeds; // threads run different seeds at the same time
+                if (runOnce(prog, input, seed + 1) != expected[seed])
+                    differences++;
+            }
+        }));
+    for (int t = 0; t < threads; t++)
+        workers[t].join();
+
+    int runs = threads * rounds;
+    cout << runs << " runs of " << script << " on " << threads << " threads, "
+         << differences << " with different output" << endl;
+    if (differences > 0) {
+        cout << "expected (seed 1):" << endl << expected[0];
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+; run by mm_stress on many threads at once: rand, INPUT, GLOBALs, arrays,
+; maps, recursion and an error, all of which must stay per context
+GLOBAL calls
+DECLARE n, i, total, a[50], seen MAP
+INPUT n
+FOR i := 0 TO 49
+  a[i] := rand() % 1000
+ENDFOR
+FOR i := 1 TO n
+  total += fib(i % 12)
+  seen{a[i % 50] % 17} += 1
+ENDFOR
+PRINTLN "sum ", sum(a), " total ", total, " calls ", calls, " keys ", size(seen)
+PRINTLN "max ", maxof(a), " gcd ", gcd(a[0], a[1])
+PRINTLN missing
+FUNCTION fib(k)
+  calls += 1
+  IF k < 2
+    RETURN k
+  ENDIF
+  RETURN fib(k - 1) + fib(k - 2)
@@ -0,0 +1,17 @@
+; recursive Ackermann, arguments kept small enough for the 100 value stack
+DECLARE i, total
+i := 0
+total := 0
+WHILE i < 20
+  total := total + ack(3, 1) + ack(2, 2) + ack(1, 10)
+  i := i + 1
+ENDWHILE
+PRINTLN "ack total ", total
+FUNCTION ack(m, n)
+  IF m = 0
+    RETURN n + 1
+  ENDIF
+  IF n = 0
+    RETURN ack(m - 1, 1)
+  ENDIF
+  RETURN ack(m - 1, ack(m, n - 1))
@@ -0,0 +1,14 @@
+; every builtin called inside an expression, where loadProg swaps its name for its id
+DECLARE i, total, a[64], b[64], m MAP
+FOR i := 0 TO 63
+  b[i] := i % 9 - 4
+ENDFOR
+FOR i := 1 TO 400
+  total += rand() % 1 + abs(i - 200) + min(i, 50) + max(i % 7, 3) + pow(i % 3, 4) + sqrt(i) + gcd(i, 84)
+  total += fill(a, i % 5) + copy(a, b, 0, i % 10) + sum(a) + minof(a) + maxof(a) + counteq(a, 0)
+  total += dot(a, b) + prefixsum(a, 0, 8) + fill(a, 0)
+  m{i % 23} += 1
+  total += has(m, i % 29) + size(m) + key(m, 0) + size(a)
+  total += remove(m, i % 31)
+ENDFOR
+PRINTLN "total ", total
@@ -0,0 +1,6 @@
+; native math builtins where scripts used to write their own recursive FUNCTIONs
+DECLARE i, total
+FOR i := 1 TO 3000
+  total += gcd(i * 12, 360) + sqrt(i * i + i) + abs(500 - i) % 7 + max(i % 5, 2) + pow(i % 4, 3)
+ENDFOR
+PRINTLN "total ", total
@@ -0,0 +1,18 @@
+; call heavy procedures and functions
+DECLARE i, total
+i := 0
+total := 0
+WHILE i < 5000
+  total := total + twice(i) - inc(i)
+  tick(i)
+  i := i + 1
+ENDWHILE
+PRINTLN "total ", total
+FUNCTION twice(a)
+  RETURN a + a
+FUNCTION inc(a)
+  RETURN a + 1
+PROCEDURE tick(a)
+  DECLARE b
+  b := a * 2
+  RETURN
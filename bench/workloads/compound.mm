@@ -0,0 +1,7 @@
+; for_loop.mm with a compound assignment
+DECLARE i, total
+total := 0
+FOR i := 0 TO 99999
+  total += i % 10
+ENDFOR
+PRINTLN "total ", total
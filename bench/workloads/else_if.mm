@@ -0,0 +1,25 @@
+; nested_if.mm with ELSE and ELSEIF, every condition is tested once
+DECLARE i, small, even, odd, big
+i := 0
+small := 0
+even := 0
+odd := 0
+big := 0
+WHILE i < 30000
+  IF i < 1000
+    small := small + 1
+  ELSEIF i % 2 = 0
+    IF i % 3 = 0
+      even := even + 2
+    ELSE
+      even := even + 1
+    ENDIF
+  ELSE
+    odd := odd + 1
+    IF i > 20000
+      big := big + 1
+    ENDIF
+  ENDIF
+  i := i + 1
+ENDWHILE
+PRINTLN "small ", small, " even ", even, " odd ", odd, " big ", big
@@ -0,0 +1,7 @@
+; recursive fib
+PRINTLN "fib ", fib(18)
+FUNCTION fib(k)
+  IF k < 2
+    RETURN k
+  ENDIF
+  RETURN fib(k - 1) + fib(k - 2)
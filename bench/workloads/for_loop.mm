@@ -0,0 +1,7 @@
+; the counting loop of loop.mm as a FOR
+DECLARE i, total
+total := 0
+FOR i := 0 TO 99999
+  total := total + i % 10
+ENDFOR
+PRINTLN "total ", total
@@ -0,0 +1,14 @@
+; shared state in GLOBALs instead of passed down every call
+GLOBAL limit, visits
+DECLARE i, total
+limit := 12
+FOR i := 1 TO 300
+  total += walk(1)
+ENDFOR
+PRINTLN "total ", total, " visits ", visits
+FUNCTION walk(n)
+  visits += 1
+  IF n >= limit
+    RETURN 1
+  ENDIF
+  RETURN walk(n + 1) + 1
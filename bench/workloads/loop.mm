@@ -0,0 +1,9 @@
+; tight counting loop
+DECLARE i, total
+i := 0
+total := 0
+WHILE i < 100000
+  total := total + i % 10
+  i := i + 1
+ENDWHILE
+PRINTLN "total ", total
@@ -0,0 +1,11 @@
+; counting with a MAP: the keys are sparse so an array would not do
+DECLARE counts MAP
+DECLARE i, n, total
+FOR i := 1 TO 20000
+  n := (i * 7919) % 1000003
+  counts{n % 4099} += 1
+ENDFOR
+FOR i := 0 TO size(counts) - 1
+  total += counts{key(counts, i)}
+ENDFOR
+PRINTLN "keys ", size(counts), " total ", total, " has17 ", has(counts, 17)
@@ -0,0 +1,30 @@
+; nested IFs classifying every number
+DECLARE i, small, even, odd, big
+i := 0
+small := 0
+even := 0
+odd := 0
+big := 0
+WHILE i < 30000
+  IF i < 1000
+    small := small + 1
+  ENDIF
+  IF i >= 1000
+    IF i % 2 = 0
+      IF i % 3 = 0
+        even := even + 2
+      ENDIF
+      IF i % 3 <> 0
+        even := even + 1
+      ENDIF
+    ENDIF
+    IF i % 2 <> 0
+      odd := odd + 1
+      IF i > 20000
+        big := big + 1
+      ENDIF
+    ENDIF
+  ENDIF
+  i := i + 1
+ENDWHILE
+PRINTLN "small ", small, " even ", even, " odd ", odd, " big ", big
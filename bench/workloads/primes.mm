@@ -0,0 +1,21 @@
+; count primes by trial division
+DECLARE n, count
+n := 2
+count := 0
+WHILE n < 2000
+  IF isPrime(n) = 1
+    count := count + 1
+  ENDIF
+  n := n + 1
+ENDWHILE
+PRINTLN "primes below 2000 ", count
+FUNCTION isPrime(x)
+  DECLARE d
+  d := 2
+  WHILE d * d <= x
+    IF x % d = 0
+      RETURN 0
+    ENDIF
+    d := d + 1
+  ENDWHILE
+  RETURN 1
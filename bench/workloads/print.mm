@@ -0,0 +1,8 @@
+; print heavy output
+DECLARE i
+i := 0
+WHILE i < 2000
+  PRINT "line ", i, " square ", i * i
+  PRINTLN " cube ", i * i % 1000 * i % 1000
+  i := i + 1
+ENDWHILE
@@ -0,0 +1,16 @@
+; sieve of Eratosthenes over an array
+DECLARE composite[20000], i, n, count
+i := 2
+count := 0
+WHILE i < 20000
+  IF composite[i] = 0
+    count := count + 1
+    n := i * i
+    WHILE n < 20000
+      composite[n] := 1
+      n := n + i
+    ENDWHILE
+  ENDIF
+  i := i + 1
+ENDWHILE
+PRINTLN "primes below 20000 ", count
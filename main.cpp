@@ -7,19 +7,175 @@
 //
 
 #include <iostream>
-#include "Program.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "AllocationTracker.h"
+#include "ArrayKernels.h"
+#include "BatchRunner.h"
+#include "CompiledProgram.h"
+#include "ExecutionContext.h"
 #include "support.hpp"
-#include <stdlib.h>
+#include <ctime>
 
-int main() {
-    Program prog;
-    SymbolTable local; // define a local symbol table for execute to use per function/prodecure
-    srand(time(0)); // set seed for rand
+/** batch
+ input: path (manifest or directory), options and summary file name
+ output: run every script, print their output in manifest order (unless an output
+ directory is given), write the summary and return 1 if any script failed, else 0
+ */
+int batch(string path, BatchOptions &options, string summary) {
+    vector<BatchJob> jobs;
+    if (!readJobs(path, jobs)) {
+        cout << "Could not open " << path << endl;
+        return 1;
+    }
+    vector<BatchResult> results = runBatch(jobs, options);
+    int failed = 0;
+    for (int i = 0; i < results.size(); i++) {
+        if (options.outDir == "")
+            cout << "== " << jobs[i].name << " ==" << endl << results[i].output;
+        else if (results[i].status == BATCH_WRITE_FAILED)
+            cout << "Could not write " << options.outDir << "/" << jobs[i].name << ".out" << endl;
+        if (results[i].status != BATCH_OK)
+            failed++;
+    }
+    if (summary != "" && !writeSummary(summary, jobs, results))
+        cout << "Could not write " << summary << endl;
+    cout << jobs.size() << " scripts, " << failed << " failed" << endl;
+    return failed > 0 ? 1 : 0;
+} // end batch
+
+int main(int argc, char *argv[]) {
+    string batchPath, summary;
+    BatchOptions options;
+    bool profile = false;
+    string foldedFile;
+    string sampleFile;
+    int sampleUs = SAMPLE_INTERVAL_US;
+    bool stats = false, statsJson = false, counts = false;
+    string traceFile;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            batchPath = argv[++i];
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+            options.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            options.outDir = argv[++i];
+        else if (strcmp(argv[i], "--summary") == 0 && i + 1 < argc)
+            summary = argv[++i];
+        else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc)
+            options.quantum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-statements") == 0 && i + 1 < argc)
+            options.maxStatements = atol(argv[++i]);
+        else if (strcmp(argv[i], "--deadline") == 0 && i + 1 < argc)
+            options.deadlineMs = atol(argv[++i]);
+        else if (strcmp(argv[i], "--profile") == 0)
+            profile = true;
+        else if (strcmp(argv[i], "--profile-calls") == 0 && i + 1 < argc)
+            foldedFile = argv[++i];
+        else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc)
+            sampleFile = argv[++i];
+        else if (strcmp(argv[i], "--sample-us") == 0 && i + 1 < argc)
+            sampleUs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats = true;
+        else if (strcmp(argv[i], "--stats-json") == 0)
+            stats = statsJson = true;
+        else if (strcmp(argv[i], "--counts") == 0)
+            counts = true;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            traceFile = argv[++i];
+        else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            if (!selectArrayKernels(argv[++i])) {
+                cout << "This CPU cannot run the " << argv[i] << " array kernels" << endl;
+                return 1;
+            }
+        }
+        else {
+            cout << "usage: " << argv[0] << " [--max-statements n] [--deadline ms] [--profile] [--profile-calls file.folded]"
+                 << endl
+                 << "       [--sample file.folded [--sample-us microseconds]] [--stats | --stats-json] [--counts]"
+                 << endl << "       [--trace file.json] [--simd scalar|sse2|avx2]" << endl
+                 << "       [--batch manifest|directory [--jobs n] [--out dir] [--summary file.csv] [--quantum lines]]"
+                 << endl;
+            return 1;
+        }
+    }
+    if (batchPath != "") {
+        int status = batch(batchPath, options, summary);
+#ifdef MM_TRACK_ALLOCATIONS
+        cout << endl << "Allocations" << endl;
+        printAllocations(cout);
+#endif
+        return status;
+    }
+
+    CompiledProgram prog;
     bool success = false;
     do {
         success = load(prog);
     } while (!success);
-    prog.push(0); // push a dummy return for main proc
-    execute(prog, local, 0, 0);
+    ExecutionContext context(prog, time(0)); // one run of the loaded program, seed rand with the time
+    context.setLimits(options.maxStatements, options.deadlineMs);
+    LineProfiler lines;
+    CallProfiler calls;
+    unique_ptr<SamplingProfiler> sampler; // both preallocate their buffers, so only made when asked for
+    unique_ptr<Tracer> tracer;
+    if (profile)
+        context.setLineProfiler(&lines);
+    if (foldedFile != "")
+        context.setCallProfiler(&calls);
+    if (traceFile != "") {
+        tracer = unique_ptr<Tracer>(new Tracer);
+        context.setTracer(tracer.get());
+    }
+    if (sampleFile != "") {
+        sampler = unique_ptr<SamplingProfiler>(new SamplingProfiler);
+        context.setSampler(sampler.get());
+        if (!sampler->start(sampleUs))
+            cout << "Could not start the sampling timer" << endl;
+    }
+    run(context);
+    if (sampler)
+        sampler->stop();
+    if (profile) {
+        cout << endl << "Line profile" << endl;
+        lines.report(prog, cout);
+    }
+    if (foldedFile != "") {
+        cout << endl << "Call profile" << endl;
+        calls.report(cout);
+        ofstream folded(foldedFile.c_str());
+        calls.writeFolded(folded);
+        if (folded.fail())
+            cout << "Could not write " << foldedFile << endl;
+    }
+    if (sampleFile != "") {
+        cout << endl << "Sampled profile" << endl;
+        sampler->report(prog, cout);
+        ofstream folded(sampleFile.c_str());
+        sampler->writeFolded(prog, folded);
+        if (folded.fail())
+            cout << "Could not write " << sampleFile << endl;
+    }
+    if (traceFile != "") {
+        ofstream trace(traceFile.c_str());
+        tracer->write(prog, trace);
+        if (trace.fail())
+            cout << "Could not write " << traceFile << endl;
+    }
+    if (stats) {
+        if (!statsJson)
+            cout << endl << "Interpreter stats" << endl;
+        printStats(context.getStats(), cout, statsJson);
+    }
+    if (counts) {
+        printCounts(context.getStats(), cout);
+        cout << endl;
+    }
+#ifdef MM_TRACK_ALLOCATIONS
+    cout << endl << "Allocations" << endl;
+    printAllocations(cout);
+#endif
     return 0;
 }
@@ -7,10 +7,43 @@
 //
 
 #include "support.hpp"
+#include "AllocationTracker.h"
+#include "Builtins.h"
 
 using namespace std;
 
 
+/** operate
+ input: op (+ - * / or %), target and value
+ output: target op= value. Dividing by zero (/ or %) is an error and leaves target as it
+ was, and INT_MIN / -1 wraps around like the other operators do instead of trapping
+ changed: target
+ */
+static void operate(ExecutionContext &p, char op, int &target, int value) {
+    switch (op) {
+        case '+':
+            target += value;
+            break;
+        case '-':
+            target -= value;
+            break;
+        case '*':
+            target *= value;
+            break;
+        case '/':
+        case '%':
+            if (value == 0)
+                p.errorMsg("Division by zero");
+            else if (value == -1) // x / -1 is -x (wrapping), x % -1 is 0
+                target = op == '/' ? (int) (0u - (unsigned int) target) : 0;
+            else if (op == '/')
+                target /= value;
+            else
+                target %= value;
+            break;
+    }
+} // end operate
+
 /** calculate
  Input: postFix stack created by parseEquation, local SymbolTable, and success boolean
  output: calculated value
@@ -18,7 +51,8 @@ using namespace std;
  Use the passed local SymbolTable to look up variables. Function is recursive
  changed: postFix
  */
-int calculate(Program &p, Stack<string> &postFix, SymbolTable &local, bool &success) {
+int calculate(ExecutionContext &p, Stack<string> &postFix, SymbolTable &local, bool &success) {
+    AllocationScope phase(ALLOC_EVALUATE);
     int result = 0, result2 = 0;
     string s, operand1, operand2;
     success = true; // be optimistic
@@ -58,51 +92,85 @@ int calculate(Program &p, Stack<string> &postFix, SymbolTable &local, bool &succ
         }
         //cout << "operator " << s << " operand1 " << operand1 << " operand2 " << operand2 << endl;
         //cout << "Values " << result << " " << result2 << endl;
-        switch (s[0]) // do operation
-        {
-            case '+' :
-                result += result2;
-                break;
-            case '-' :
-                result -= result2;
-                break;
-            case '*' :
-                result *= result2;
-                break;
-            case '/' :
-                result /= result2;
-                break;
-            case '%' :
-                result %= result2;
-                break;
-        }
+        p.getStats().operations++;
+        operate(p, s[0], result, result2); // do operation
     }
     return result;
 } // end calculate
 
-/** compare
- input: line (with the boolean compare) and local SymbolTable
- output: extract two values and an operation string from line, use the SymbolTable to look up locals,
- and return true or false
- changed: line
+/** callMethod
+ input: method (Symbol already found by getMethod), args (in parenthesis) and the caller's local SymbolTable
+ output: push the return value space (functions only), the return line and the arguments, execute the
+ method with a new SymbolTable, then put the caller back where it was. Returns the function value (0 for a procedure)
+ changed: p and args
  */
-bool compareBool(Program &p, SymbolTable &local) {
+int callMethod(ExecutionContext &p, Symbol &method, string &args, SymbolTable &local) {
+    AllocationScope phase(ALLOC_CALL);
+    int result = 0;
+    bool function = method.getType() == FUNC;
+    if (!p.tick()) // limits are checked at every call
+        return 0;
+    string rest = p.getLine(); // callee reuses the line, keep the caller's
+    SymbolTable t; // create a symbol table for the method
+    if (function)
+        p.push(0); // space for return value
+    p.push(p.getLineNumber()); // put return address on stack
+    int numParms = p.countArguments(local, args); // count and put args onto stack
+    RunStats &stats = p.getStats();
+    stats.calls++;
+    if (++stats.callDepth > stats.maxCallDepth)
+        stats.maxCallDepth = stats.callDepth;
+    CallProfiler *calls = p.getCallProfiler();
+    SamplingProfiler *sampler = p.getSampler();
+    Tracer *tracer = p.getTracer();
+    long long start = 0;
+    if (tracer != NULL) {
+        tracer->stackSize(p.getStackSize());
+        start = tracer->now();
+    }
+    if (calls != NULL)
+        calls->enter(method.getOffset(), method.getSymbol());
+    if (sampler != NULL)
+        sampler->enter(method.getOffset());
+    execute(p, t, method.getOffset(), numParms); // do the method with new symbol table
+    stats.callDepth--;
+    if (calls != NULL)
+        calls->leave();
+
+    p = p.peek(); // back to the return address
+    if (sampler != NULL) {
+        sampler->leave();
+        sampler->atLine(p.getLineNumber() - 1); // samples until the next line belong to the caller
+    }
+    if (tracer != NULL)
+        tracer->span(method.getOffset(), start);
+    p.pop(1); // remove return address
+    if (function) {
+        result = p.peek(); // get the return value
+        p.pop(1); // remove return value
+    }
+    if (tracer != NULL)
+        tracer->stackSize(p.getStackSize());
+    p.setLine(rest);
+    return result;
+} // end callMethod
+
+/** compareClause
+ input: clause (one comparison of a condition) and local SymbolTable
+ output: work out both operands of clause, compare them and return the result (flipped by NOT)
+ */
+static bool compareClause(ExecutionContext &p, const Clause &clause, SymbolTable &local) {
     bool success;
     int val1, val2;
-    string operand1, compareOp, operand2;
-    p -= COMPARE;
-    operand1 *= p; // get first part of compare
-    val1 = parseEquation(p, operand1, local, success);
+    val1 = parseEquation(p, clause.left, local, success);
     if (!success)
         p.errorMsg("Invalid first operand of compare");
-    p -= CMD;
-    compareOp *= p;
-    p -= EQUATION;
-    operand2 *= p;
-    val2 = parseEquation(p, operand2, local, success);
+    val2 = parseEquation(p, clause.right, local, success);
     if (!success)
         p.errorMsg("Invalid second operand of compare");
     success = false;
+    p.getStats().operations++;
+    const string &compareOp = clause.op;
     if (compareOp == "=")
         success = (val1 == val2);
     else if (compareOp == "<")
@@ -115,11 +183,50 @@ bool compareBool(Program &p, SymbolTable &local) {
         success = (val1 >= val2);
     else if (compareOp == "<>")
         success = (val1 != val2);
-    else
-        p.errorMsg("Invalid comparision operation of " + compareOp);
-    return success;
+    return success != clause.negate;
+} // end compareClause
+
+/** compare
+ input: p at an IF, ELSEIF or WHILE line and local SymbolTable
+ output: return the line's condition, compiled at load time. AND binds tighter than OR and
+ both short-circuit: once a clause decides the result the rest are never worked out
+ */
+bool compareBool(ExecutionContext &p, SymbolTable &local) {
+    const vector<Clause> &clauses = p.getProgram().getCondition(p.getLineNumber() - 1);
+    bool group = true; // the clauses ANDed together since the last OR
+    for (int i = 0; i < clauses.size(); i++) {
+        if (group) // a false clause decides the rest of its group
+            group = compareClause(p, clauses[i], local);
+        if (clauses[i].orNext || i == clauses.size() - 1) {
+            if (group) // a true group decides the whole condition
+                return true;
+            group = true;
+        }
+    }
+    return false;
 } // end compare
 
+/** isMapDeclaration
+ input: token of a DECLARE and name
+ output: if token is "name MAP" (MAP in any case) fill in name and return true, else return false
+ changed: name
+ */
+static bool isMapDeclaration(string token, string &name) {
+    size_t space = token.find(' ');
+    if (space == string::npos)
+        return false;
+    string kind = token.substr(space + 1);
+    size_t first = kind.find_first_not_of(' ');
+    size_t last = kind.find_last_not_of(' ');
+    kind = first == string::npos ? "" : kind.substr(first, last - first + 1);
+    for (int i = 0; i < kind.length(); i++)
+        kind[i] = toupper(kind[i]);
+    if (kind != "MAP")
+        return false;
+    name = token.substr(0, space);
+    return true;
+} // end isMapDeclaration
+
 /** convertOperand
  input: s (has operand), local SymbolTable, and boolean success
  output: convert operand into a value
@@ -127,9 +234,10 @@ bool compareBool(Program &p, SymbolTable &local) {
  function calls start with a FUNCTION_ARG character (put on by parseEquation, not user).
  changed: s, table and success
  */
-int convertOperand(Program &p, string &s, SymbolTable &table, bool &success) {
+int convertOperand(ExecutionContext &p, string &s, SymbolTable &table, bool &success) {
     int result = 0;
     Symbol sym;
+    string name, index; // of an array element
     bool unaryMinus = false;
     if (s.length() > 0) {
         if (s[0] == '+') // unary plus
@@ -145,14 +253,36 @@ int convertOperand(Program &p, string &s, SymbolTable &table, bool &success) {
         }
         if (isdigit(s[0])) { // get literal
             result = atoi(s.c_str());
+        } else if (isalnum(s[0]) && splitIndex(s, name, index)) { // get array element
+            int *slot = p.element(name, parseEquation(p, index, table, success), table);
+            if (slot != NULL)
+                result = *slot;
+        } else if (isalnum(s[0]) && splitKey(s, name, index)) { // get map entry, 0 if missing
+            int key = parseEquation(p, index, table, success);
+            IntMap *values = p.map(name, table);
+            if (values != NULL)
+                result = values->get(key);
         } else if (isalnum(s[0])) { // get variable
             sym = Symbol(s, 0, NONE);
-            if (!table.get(sym))
-                p.errorMsg(s + " variable not found");
+            if (!table.get(sym)) { // not a local, so a GLOBAL
+                int *value = p.global(s);
+                if (value == NULL)
+                    p.errorMsg(s + " variable not found");
+                else
+                    result = *value;
+            } else if (sym.getType() == ARRAY)
+                p.errorMsg(s + " is an array, give an index");
+            else if (sym.getType() == MAP)
+                p.errorMsg(s + " is a map, give a key in { }");
             else if (sym.getType() != VARIABLE)
                 p.errorMsg(s + " is not a variable");
             else
                 result = p.peek(sym.getOffset());
+        } else if (s[0] == FUNCTION_ARG && s.length() > 2 && s[1] == BUILTIN_CALL) { // builtin found by loadProg
+            BuiltinId builtin = (BuiltinId) (s[2] - BUILTIN_ID_BASE); // callBuiltin checks the range
+            s = s.substr(3);
+            p.trimIt(s);
+            result = callBuiltin(p, builtin, s, table);
         } else if (s[0] == FUNCTION_ARG) { // get function
             s = s.substr(1); // remove the function indicator
             string temp;
@@ -167,25 +297,12 @@ int convertOperand(Program &p, string &s, SymbolTable &table, bool &success) {
                 s = s.substr(x);
                 p.trimIt(s);
                 sym = Symbol(temp, 0, NONE);
-                if (temp == "rand") {
-                    result = rand();
-                    p.trim(PARENTHESIS, s);
-                    if (s != "")
-                        p.errorMsg("built-in function rand has no parameters");
-                } else if (!p.getMethod(sym)) // functions and procedures in "methods"
+                if (!p.getMethod(sym)) // functions and procedures in "methods"
                     p.errorMsg(temp + " function not found");
-                else { // call function
-                    SymbolTable t; // create a symbol table for the function
-                    p.push(0); // space for return value
-                    p.push(p.getLineNumber()); // put return address on stack
-                    int numParms = p.countArguments(table, s); // count and put args onto stack
-                    execute(p, t, sym.getOffset(), numParms); // do the function with new symbol table
-
-                    p.setLineNumber(p.peek()); // set the return address
-                    p.pop(1); // remove return address
-                    result = p.peek(); // get the return value
-                    p.pop(1); // remove return value
-                }
+                else if (sym.getType() != FUNC)
+                    p.errorMsg(temp + " is not a function");
+                else // call function
+                    result = callMethod(p, sym, s, table);
             }
         } else
             p.errorMsg(s + " unknown operand");
@@ -195,8 +312,30 @@ int convertOperand(Program &p, string &s, SymbolTable &table, bool &success) {
     return result;
 } // end convertOperand
 
+/** compoundAssign
+ input: op (':' for a plain assign, else the operator of += -= *= /= %=), target and value
+ output: store value in target, or combine it with what target holds
+ changed: target
+ */
+static void compoundAssign(ExecutionContext &p, char op, int &target, int value) {
+    if (op == ':')
+        target = value;
+    else {
+        p.getStats().operations++;
+        operate(p, op, target, value);
+    }
+} // end compoundAssign
+
+// a FOR that is running: where it is, its variable and the bounds worked out as it started
+struct ActiveFor {
+    int line; // the FOR line
+    int *counter; // the variable's slot on the stack
+    int last;
+    int step;
+};
+
 /** execute
- Will take the Program object p with the addition of:
+ Will take the ExecutionContext object p with the addition of:
    1. A local SymbolTable
    2. Where to start in the MinusMinus code (lineStart)
    3. The number of parmeters (numParms)
@@ -204,26 +343,27 @@ int convertOperand(Program &p, string &s, SymbolTable &table, bool &success) {
             p object's stack and the local SymbolTable
             will link up the parameter name with the
             stack offset
- Sets up needed variables and even has a whiles stack
-    for use with keeping track of the top of current while
+ Sets up needed variables and even has a fors stack
+    for the FOR loops running (bounds and variable slot)
  Will do a loop with a switch statement for executing
     MinusMinus instrucions until either the boolean run
     is false or an error occurs
  */
-void execute(Program &p, SymbolTable &local, int lineStart, int numParms) {
+void execute(ExecutionContext &p, SymbolTable &local, int lineStart, int numParms) {
     Symbol lookup; // for looking up from SymbolTable
-    Stack<int> whiles;
+    BuiltinId builtin; // run by a CALL line
+    Stack<ActiveFor> fors;
     p.setLineNumber(lineStart);
     //cout << "start at " << lineStart << endl;
     Commands codeMethod = ++p;
-    Commands command;
     bool success, run = true, print = false;
+    bool branching = false; // an IF or ELSEIF was false, the next ELSEIF or ELSE decides
     int temp = 1; // for first parm
     int numLocals = 0; // count how many locals on stack
+    int arrays = p.getArrayCount(); // arrays declared before this frame, the rest are freed on the way out
+    int maps = p.getMapCount(); // the same for maps
     int val; // scratch variable
-    int numIfs = 0; // to count nested ifs for endif
-    int numWhiles = 0; // to count nested whiles for endwhile
-    string token, compare, variable, method;
+    string token, compare, variable, method, name, index;
     while (codeMethod == COMMENT || codeMethod == BLANK)
         codeMethod = ++p; // skip leading comments and blank lines
     if (codeMethod == FUNCTION || codeMethod == PROCEDURE) {
@@ -242,71 +382,95 @@ void execute(Program &p, SymbolTable &local, int lineStart, int numParms) {
             p -= COMMA; // get past comma
             temp++;
         }
-    }
+    } else if (codeMethod != ENDPROGRAM)
+        p = p.getLineNumber() - 1; // main program without a heading, run its first line too
     while (run && p.getErrorCount() == 0) {
         //cout << "at line " << p.getLineNumber()+1 << endl;
         // switch (++p) // now to start executing function/procedure code
-        ++p; // point to next command
-        Commands cmd;
-        cmd *= p; // ASSIGN
-        /*
-        string str;
-        str *= p;
-        cout << "cmd = " << str << " line " << p.getLineNumber()<< endl;
-        cin >> str;
-        */
+        Commands cmd = ++p; // point to next command
+        // times this line when profiling, but not running off the end (that is no line)
+        LineTimer timer(cmd == ENDPROGRAM ? NULL : p.getLineProfiler(), p.getLineNumber() - 1);
+        AllocationScope phase(ALLOC_EXECUTE); // the line itself, parse, evaluate, calls and print set their own
         switch (cmd) {
             case ASSIGN:
-                // TODO fill in the code --done
-            {
                 variable *= p;  // get the last token  -- get lhs
-                p -= CMD; // get next token -- move to the next token
-                token *= p; // get the last token  --get operator
-                if (token != ":=") {
-                    p.errorMsg("not assign statement"); // this is redundatnt bc ASSIGN has determined it already
-                }
                 p -= EQUATION; // get next token to the end of the line
-                token *= p; // get the last token -- rhs
+                token *= p; // get the last token  --operator and rhs
+                compare = token.substr(0, 2); // := or a compound operator, checked by convertLine
+                token.erase(0, 2);
+                if (splitIndex(variable, name, index)) { // array element
+                    val = parseEquation(p, index, local, success);
+                    temp = parseEquation(p, token, local, success);
+                    int *slot = p.element(name, val, local);
+                    if (slot != NULL)
+                        compoundAssign(p, compare[0], *slot, temp);
+                    break;
+                }
+                if (splitKey(variable, name, index)) { // map entry, added if missing
+                    val = parseEquation(p, index, local, success);
+                    temp = parseEquation(p, token, local, success);
+                    IntMap *values = p.map(name, local);
+                    if (values != NULL)
+                        compoundAssign(p, compare[0], values->at(val), temp);
+                    break;
+                }
                 temp = parseEquation(p, token, local, success); // calculated value is int
-                p.poke(variable, temp, local); // place variable on the stack
+                if (compare == ":=")
+                    p.poke(variable, temp, local); // place variable on the stack
+                else { // one lookup, then update the slot in place
+                    int *slot = p.slot(variable, local);
+                    if (slot != NULL)
+                        compoundAssign(p, compare[0], *slot, temp);
+                }
+                break;
+            case BREAK:
+                val = p.getProgram().getJump(p.getLineNumber() - 1); // ENDWHILE or ENDFOR
+                if (p.getProgram().getCommand(val) == ENDFOR)
+                    fors.pop(); // the innermost FOR running is the one left
+                p = val + 1;
                 break;
-            }
             case CALL:
-                // TODO fill in the code -- params are not done
-            {
                 method *= p; // get last token --method name that was called
                 lookup = Symbol(method, 0, PROC);  // create a symbol for the method
-                bool found = p.getMethod(lookup);
-                if (!found) {
+                builtin = p.getProgram().getBuiltin(p.getLineNumber() - 1); // a script's own method wins
+                if (builtin != NO_BUILTIN) { // its value is dropped
+                    p -= LINE;
+                    token *= p;
+                    callBuiltin(p, builtin, token, local);
+                } else if (!p.getMethod(lookup)) {
                     p.errorMsg("Not found: " + method);
                 } else {
-                    SymbolTable localVar;  // new local symbol table for the call
-                    p -= OPEN_PARM;
-
-
-                    string params;
-                    params *= p; // get the last token --params
-                    cout << "params: " << params << endl; // params  TODO not working
-
-                    p.push(p.getLineNumber()); // push the return line number on p's stack
-                    p.countArguments(localVar, params);  // push local variables on the stack
-                    execute(p, localVar, lookup.getOffset(), temp);
+                    p -= LINE;
+                    token *= p; // get the last token --arguments in parenthesis
+                    callMethod(p, lookup, token, local);
                 }
-
-            }
                 break;
             case COMMENT:  // ignore
             case BLANK:    // ignore
                 break;
+            case CONTINUE:
+                val = p.getProgram().getJump(p.getLineNumber() - 1); // WHILE or ENDFOR
+                if (p.getProgram().getCommand(val) == WHILE)
+                    p.tick(); // a backward jump, ENDFOR does its own
+                p = val;
+                break;
             case DECLARE:
-                // TODO fill in the code --done
-            {
                 token = "flag";
                 while (token != "") { // nextToken returns "" if nothing left
                     p -= COMMA; // get next token, finish before comma reached
                     token *= p; //get the last token --variable name
-                    if (p.isValidID(token)) {
-                        p.push(token, local); // sore variable in the symbol table local
+                    if (splitIndex(token, name, index)) { // array of index elements
+                        val = parseEquation(p, index, local, success);
+                        if (!p.isValidID(name))
+                            p.errorMsg("bad identifier: " + name);
+                        else if (p.pushArray(name, val, local))
+                            numLocals++;
+                    } else if (isMapDeclaration(token, name)) {
+                        if (p.isValidID(name) && p.pushMap(name, local))
+                            numLocals++;
+                    } else if (p.isValidID(token)) {
+                        if (p.push(token, local)) // store variable in the symbol table local
+                            numLocals++;
                     } else {
                         p.errorMsg("bad identifier: " + token);
                     }
@@ -318,179 +482,197 @@ void execute(Program &p, SymbolTable &local, int lineStart, int numParms) {
                     }
                 }
                 break;
-            }
-            case ENDIF:
-                // TODO fill in the code --done
-            {
-                //Make sure you have a matching if (i.e. numIfs) and decrement numIfs
-                if (numIfs == temp) {
-                    numIfs--;
-                } else {
-                    p.errorMsg("Missing if");
+            case ENDFOR: {
+                if (fors.getStackSize() == 0 || fors.peek().line != p.getProgram().getJump(p.getLineNumber() - 1)) {
+                    p.errorMsg("Missing for");
+                    break;
+                }
+                ActiveFor loop = fors.peek();
+                long long next = (long long) *loop.counter + loop.step; // no overflow at the ends of int
+                if (loop.step > 0 ? next > loop.last : next < loop.last)
+                    fors.pop(); // done, the variable keeps the last value run
+                else {
+                    *loop.counter = (int) next;
+                    p.tick(); // and at every backward jump
+                    p = loop.line + 1; // straight to the body, the bounds are already known
                 }
                 break;
             }
-
+            case ELSE:
+                if (!branching) // the branch before ran, skip to the ENDIF
+                    p = p.getProgram().getBlockEnd(p.getLineNumber() - 1) + 1;
+                branching = false;
+                break;
+            case ENDIF: // matched with its IF at load time
+                break;
             case ENDPROGRAM: // ran out of code
+                p.pop(numLocals);
+                p.freeArrays(arrays);
+                p.freeMaps(maps);
                 run = false;
                 return; // exit
             case ENDWHILE:
-                // TODO fill in the code --done
-                if (numWhiles == temp) {
-                    //Decrement numWhiles (it will be increment if while loop done again)
-                    numWhiles--;
-                } else {
-                    p.errorMsg("Missing while");
+                p.tick(); // and at every backward jump
+                p = p.getProgram().getJump(p.getLineNumber() - 1); // back to the while to test it again
+                break;
+            case FOR: {
+                ActiveFor loop;
+                loop.line = p.getLineNumber() - 1;
+                const ForHeader &header = p.getProgram().getForHeader(loop.line);
+                variable *= p; // the loop variable, split off at load time
+                val = parseEquation(p, header.from, local, success);
+                loop.last = parseEquation(p, header.to, local, success);
+                loop.step = header.step == "" ? 1 : parseEquation(p, header.step, local, success);
+                loop.counter = p.slot(variable, local);
+                if (loop.counter == NULL)
+                    break;
+                if (loop.step == 0) {
+                    p.errorMsg("FOR STEP cannot be 0");
+                    break;
                 }
+                *loop.counter = val;
+                if (loop.step > 0 ? val > loop.last : val < loop.last)
+                    p = p.getProgram().getJump(loop.line) + 1; // nothing to run, carry on after the ENDFOR
+                else if (!fors.push(loop))
+                    p.errorMsg("Too many nested FORs");
                 break;
+            }
             case FUNCTION:
-            case PROCEDURE:
-// TODO fill in the code FUNCITON, PROCEDURE  --done?
+            case PROCEDURE: // ran into the next method
                 p.pop(numLocals);
+                p.freeArrays(arrays);
+                p.freeMaps(maps);
                 return; // exit
-            case IF:
-// TODO fill in the code --done --not sure
-            {
-                success = compareBool(p, local);
-                if (success) {
-                    numIfs++;
-                } else {
-                    temp = 1; //temp = # of end if (looking for one endif)
-                    do {
-                        command = UNKNOWN; // TODO -- not sure this should be here
-                        while (command != ENDIF &&
-                               command != ENDPROGRAM &&
-                               command != FUNCTION &&
-                               command != PROCEDURE) {
-                            if (command == IF)
-                                temp++; //nested if, another endif
-                            command = ++p;
-                        }
-                        temp--;
-                    } while (temp != 0);
-                    if (command != ENDIF)
-                        p.errorMsg("If with no matching endIf");
+            case GLOBAL: // given slots at load time
+                break;
+            case ELSEIF:
+                if (!branching) { // the branch before ran, skip to the ENDIF
+                    p = p.getProgram().getBlockEnd(p.getLineNumber() - 1) + 1;
+                    break;
                 }
+                // fall through - an ELSEIF reached by branching is worked out like an IF
+            case IF:
+                val = p.getProgram().getJump(p.getLineNumber() - 1); // the next branch or the ENDIF
+                branching = !compareBool(p, local);
+                if (branching && p.getProgram().getCommand(val) == ENDIF) {
+                    branching = false;
+                    p = val + 1;
+                } else if (branching)
+                    p = val; // ELSEIF or ELSE, which sees branching
                 break;
-            }
             case INPUT:
-                // TODO fill in the code INPUT --draft --not_tested
-            {
                 p -= COMMA;
                 token *= p;
-                if (token.at(0) == '\"') {
+                if (checkFirstChar(token, '"')) {
                     p.trim(QUOTE, token);
-                    cout << token;
+                    p.getOut() << token;
                     p -= COMMA;
                     token *= p;
-                    if (token != ",") {
-                        p.errorMsg("Missing comma at line:" + p.getLineNumber());
-                    }
-                }
-                while (token != "") {
+                    if (token != ",")
+                        p.errorMsg("Missing comma");
                     p -= COMMA;
                     token *= p;
+                }
+                while (token != "") {
                     lookup = Symbol(token, 0, NONE);
-                    if (!local.get(lookup)) {
+                    if (splitIndex(token, name, index)) { // array element
+                        int *slot = p.element(name, parseEquation(p, index, local, success), local);
+                        if (slot != NULL)
+                            p.getIn() >> *slot;
+                    } else if (splitKey(token, name, index)) { // map entry
+                        val = parseEquation(p, index, local, success);
+                        IntMap *values = p.map(name, local);
+                        if (values != NULL)
+                            p.getIn() >> values->at(val);
+                    } else if (!local.get(lookup) && p.global(token) == NULL) {
                         p.errorMsg("variable not found: " + token);
                     } else {
-                        cin >> val;
+                        val = 0;
+                        if (p.getTracer() != NULL) {
+                            long long start = p.getTracer()->now();
+                            p.getIn() >> val;
+                            p.getTracer()->span(TRACE_INPUT, start);
+                        } else
+                            p.getIn() >> val;
                         p.poke(token, val, local);
                     }
+                    p -= COMMA; // get past comma
+                    token *= p;
+                    if (token != "" && token != ",")
+                        p.errorMsg("Missing comma");
+                    p -= COMMA;
+                    token *= p;
                 }
                 break;
-            }
             case PRINT:
                 print = true;
-            case PRINTLN:
-                // TODO fill in the code --done
-            {
+            case PRINTLN: {
+                AllocationScope printing(ALLOC_PRINT);
                 p -= COMMA;
                 token *= p;
                 while (token != "") {
-                    if (token.at(0) == '\"') {
+                    if (checkFirstChar(token, '"')) {
                         // remove quote
                         p.trim(QUOTE, token);
-                        cout << token;
-                        if (!print)
-                            cout << endl;
-                        print = false;
+                        p.getOut() << token;
                     } else {
                         // this is expression
-                        cout << parseEquation(p, token, local, success);
+                        p.getOut() << parseEquation(p, token, local, success);
                     }
+                    p -= COMMA; // get past comma
+                    token *= p;
+                    if (token != "" && token != ",")
+                        p.errorMsg("Missing comma");
                     p -= COMMA;
                     token *= p;
                 }
+                if (!print) {
+                    if (p.getTracer() != NULL) {
+                        long long start = p.getTracer()->now();
+                        p.getOut() << endl;
+                        p.getTracer()->span(TRACE_FLUSH, start);
+                    } else
+                        p.getOut() << endl;
+                }
+                print = false;
                 break;
             }
             case RETURN:
-// TODO fill in the code RETURN  -- draft not tested
-            {
-                p.pop(numLocals);
-
                 p -= EQUATION;
                 token *= p;
+                val = 0;
                 if (token != "") {
-                    if (codeMethod == PROCEDURE) {
-                        p.errorMsg("Procedure cannot have return value, line: " + p.getLineNumber());
-                        return;
-                    } else {
+                    if (codeMethod != FUNCTION)
+                        p.errorMsg("Procedure cannot have return value");
+                    else
                         val = parseEquation(p, token, local, success);
-                    }
-
-                } else {
-                    if (codeMethod == FUNCTION) {
-                        p.errorMsg("Function cannot have empty return value");
-                    }
+                } else if (codeMethod == FUNCTION) {
+                    p.errorMsg("Function cannot have empty return value");
                 }
-                int linenumber = p.peek();
-                p.pop(2);
-                p.push(val);
-                lineStart = linenumber;
+                p.pop(numLocals);
+                p.freeArrays(arrays);
+                p.freeMaps(maps);
+                if (codeMethod == FUNCTION)
+                    p.poke(p.getStackSize() - 2, val); // space for return value is under the return address
                 return;
-            }
             case UNKNOWN:
                 token *= p;
                 if (token != "")
                     p.errorMsg("Bad command");
                 break;
             case WHILE:
-// TODO fill in the code WHILE --draft --not_tested
-            {
                 success = compareBool(p, local);
-                if (success) {
-                    numWhiles++;
-                    whiles.push(p.getLineNumber() - 1);
-                } else {
-                    temp = 1; // num of endwhiles
-                    do {
-                        command = UNKNOWN; // TODO -- not sure this should be here
-                        while (command != ENDIF &&
-                               command != ENDPROGRAM &&
-                               command != FUNCTION &&
-                               command != PROCEDURE) {
-                            if (command == WHILE)
-                                temp++; //nested if, another endif
-                            command = ++p;
-                        }
-                        temp--;
-                    } while (temp != 0);
-                    if (command != ENDWHILE)
-                        p.errorMsg("If with no matching endWhile");
-                }
-            }
+                if (!success)
+                    p = p.getProgram().getJump(p.getLineNumber() - 1) + 1; // past the ENDWHILE
                 break;
         }
     }
 }
 
-}
-
 /**
- Get a filename, open file and pass to Program object to read from file into the object's internal program
+ Get a filename, open file and pass to CompiledProgram object to read from file into the object's internal program
  */
-bool load(Program &p) {
+bool load(CompiledProgram &p) {
     bool read = false;
     string filename, t;
     ifstream inFile;
@@ -523,17 +705,24 @@ bool load(Program &p) {
 //    Seems that parseEquation has a few minor clarifications:
 //    1. The string variables of op, and operand1 don't seemed to be used if you follow the logic of the pseudocode
 //    2. The nextFactor will put a tilde (~) on front of a function call, not parseEquation (parseEquation may ensure it is there but that's it).
-int parseEquation(Program &p, string exp, SymbolTable &local, bool &success) {
+int parseEquation(ExecutionContext &p, string exp, SymbolTable &local, bool &success) {
+    AllocationScope phase(ALLOC_PARSE);
     Stack<string> postFix;
     Stack<string> operatorStack;
     bool leadMinus = true;
     int oldLineNumber = p.getLineNumber();
     int temp;
+    p.getStats().equations++;
     string s = p.nextFactor(exp), op, operand1;
-    // TODO fill in the code --done
 
     while (!s.empty()) {
-        if (isalpha(s.at(0)) || isdigit(s.at(0)) || checkFirstChar(s, FUNCTION_ARG)) {
+        if (leadMinus && (s == "-" || s == "+") && !checkFirstChar(exp, '(')) {
+            s += p.nextFactor(exp); // unary sign, convertOperand handles it
+            postFix.push(s);
+        } else if (leadMinus && (s == "-" || s == "+")) {
+            postFix.push("0"); // unary sign on a parenthesis, make it 0 - (...)
+            operatorStack.push(s);
+        } else if (isalpha(s.at(0)) || isdigit(s.at(0)) || checkFirstChar(s, FUNCTION_ARG)) {
             postFix.push(s);
         } else if (s == "(") {
             operatorStack.push(s);
@@ -546,12 +735,16 @@ int parseEquation(Program &p, string exp, SymbolTable &local, bool &success) {
             }
             operatorStack.push(s);
         } else if (s == ")") {
-            while (operatorStack.peek() != "(") {
+            while (operatorStack.getStackSize() && operatorStack.peek() != "(") {
                 postFix.push(operatorStack.peek());
                 operatorStack.pop();
             }
+            if (!operatorStack.getStackSize())
+                p.errorMsg("Missing ( in equation");
             operatorStack.pop(); // remove (
         }
+        leadMinus = (s == "(" || p.isOperator(s)); // a sign can follow these
+        s = p.nextFactor(exp);
     }
     while (operatorStack.getStackSize()) {
         postFix.push(operatorStack.peek());
@@ -559,9 +752,32 @@ int parseEquation(Program &p, string exp, SymbolTable &local, bool &success) {
     }
 
     temp = calculate(p, postFix, local, success);
-    p.setLineNumber(oldLineNumber);
+    p = oldLineNumber;
     return temp;
 } // end parseEquation
 
+/** run
+ input: p, a fresh ExecutionContext
+ output: run the main program of p's CompiledProgram from the first line and
+ return the number of errors (programs with load errors are not started)
+ changed: p
+ */
+int run(ExecutionContext &p) {
+    SymbolTable local; // define a local symbol table for execute to use per function/prodecure
+    int loadErrors = p.getProgram().getLoadErrors();
+    if (loadErrors > 0 || p.getProgram().getSize() == 0)
+        return loadErrors;
+    RunStats *outerStats = currentStats;
+    currentStats = &p.getStats(); // count lookups and allocations for this run
+    p.push(0); // push a dummy return for main proc
+    if (p.getCallProfiler() != NULL)
+        p.getCallProfiler()->enter(-1, "main");
+    execute(p, local, 0, 0);
+    if (p.getCallProfiler() != NULL)
+        p.getCallProfiler()->leave();
+    currentStats = outerStats;
+    return p.getErrorCount();
+} // end run
+
 
 
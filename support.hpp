@@ -10,14 +10,15 @@
 #define support_hpp
 
 #include <iostream>
-#include "Program.h"
+#include "CompiledProgram.h"
+#include "ExecutionContext.h"
 #include "Stack.h"
 
 
 /**
- * Get a filename, open file and pass to Program object to read from file into the object's internal program
+ * Get a filename, open file and pass to CompiledProgram object to read from file into the object's internal program
  */
-bool load(Program &p);
+bool load(CompiledProgram &p);
 
 /** calculate
  Input: postFix stack created by parseEquation, local SymbolTable, and success boolean
@@ -26,15 +27,22 @@ bool load(Program &p);
  Use the passed local SymbolTable to look up variables. Function is recursive
  changed: postFix
  */
-int calculate(Program &p, Stack<string> &postFix, SymbolTable &local, bool &success);
+int calculate(ExecutionContext &p, Stack<string> &postFix, SymbolTable &local, bool &success);
+
+/** callMethod
+ input: method (Symbol already found by getMethod), args (in parenthesis) and the caller's local SymbolTable
+ output: push the return value space (functions only), the return line and the arguments, execute the
+ method with a new SymbolTable, then put the caller back where it was. Returns the function value (0 for a procedure)
+ changed: p and args
+ */
+int callMethod(ExecutionContext &p, Symbol &method, string &args, SymbolTable &local);
 
 /** compare
- input: line (with the boolean compare) and local SymbolTable
- output: extract two values and an operation string from line, use the SymbolTable to look up locals,
- and return true or false
- changed: line
+ input: p at an IF, ELSEIF or WHILE line and local SymbolTable
+ output: return the line's condition, compiled at load time. AND binds tighter than OR and
+ both short-circuit: once a clause decides the result the rest are never worked out
  */
-bool compareBool(Program &p, SymbolTable &local);
+bool compareBool(ExecutionContext &p, SymbolTable &local);
 
 /** convertOperand
  input: s (has operand), local SymbolTable, and boolean success
@@ -43,10 +51,10 @@ bool compareBool(Program &p, SymbolTable &local);
  function calls start with a FUNCTION_ARG character (put on by parseEquation, not user).
  changed: s, table and success
  */
-int convertOperand(Program &p, string &s, SymbolTable &table, bool &success);
+int convertOperand(ExecutionContext &p, string &s, SymbolTable &table, bool &success);
 
 /** execute
- Will take the Program object p with the addition of:
+ Will take the ExecutionContext object p with the addition of:
    1. A local SymbolTable
    2. Where to start in the MinusMinus code (lineStart)
    3. The number of parmeters (numParms)
@@ -54,13 +62,13 @@ int convertOperand(Program &p, string &s, SymbolTable &table, bool &success);
             p object's stack and the local SymbolTable
             will link up the parameter name with the
             stack offset
- Sets up needed variables and even has a whiles stack
-    for use with keeping track of the top of current while
+ Sets up needed variables and even has a fors stack
+    for the FOR loops running (bounds and variable slot)
  Will do a loop with a switch statement for executing
     MinusMinus instrucions until either the boolean run
     is false or an error occurs
  */
-void execute(Program &p, SymbolTable &local, int line, int numParms);
+void execute(ExecutionContext &p, SymbolTable &local, int line, int numParms);
 
 /** parseEquation
  input: exp, local SymbolTable, and success
@@ -70,6 +78,14 @@ void execute(Program &p, SymbolTable &local, int line, int numParms);
  by the calculate function. Routine is recursive.
  changed: p, local, success and restore lineNumber
  */
-int parseEquation(Program &p, string exp, SymbolTable &local, bool &success);
+int parseEquation(ExecutionContext &p, string exp, SymbolTable &local, bool &success);
+
+/** run
+ input: p, a fresh ExecutionContext
+ output: run the main program of p's CompiledProgram from the first line and
+ return the number of errors (programs with load errors are not started)
+ changed: p
+ */
+int run(ExecutionContext &p);
 
 #endif /* support_hpp */